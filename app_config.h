@@ -0,0 +1,453 @@
+/*******************************************************************************
+* File Name:   app_config.h
+*
+* Description: Application configuration. Selects the optional features of
+* the code example and the hardware resources they use. Every switch can be
+* overridden from the Makefile through DEFINES.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2020-2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef APP_CONFIG_H_
+#define APP_CONFIG_H_
+
+/*******************************************************************************
+* Startup (main.c)
+*******************************************************************************/
+/* Set to 1 to hold back the title and the instructions until the first
+ * single-key command, so nothing is queued to the UART ahead of the first
+ * response frame and hosts that only send binary frames never see text */
+#ifndef APP_QUICK_START_ENABLE
+#define APP_QUICK_START_ENABLE          (0)
+#endif
+
+/*******************************************************************************
+* Hot path placement (pwm_port.h)
+*******************************************************************************/
+/* Set by "make build PERF=1" to run the terminal count ISR and the functions
+ * it calls from SRAM, copied there at startup like initialized data, so the
+ * commit path never waits for flash wait states or cache misses */
+#ifndef PWM_RAMFUNC_ENABLE
+#define PWM_RAMFUNC_ENABLE              (0)
+#endif
+
+/*******************************************************************************
+* Counter clock (pwm_clock.c)
+*******************************************************************************/
+/* Counter clock the tick values of the design file and of the application
+ * are written for: clk_peri (72 MHz) through PWM_CLK, divided by 1 */
+#define PWM_CLOCK_REFERENCE_HZ          (72000000UL)
+
+/* Set to 1 to clock the counter from a 16-bit divider allocated at startup
+ * instead of PWM_CLK. All tick values are scaled to the resulting clock. */
+#ifndef PWM_CLOCK_HIRES_ENABLE
+#define PWM_CLOCK_HIRES_ENABLE          (0)
+#endif
+
+/* Divide ratio of clk_peri for the 16-bit divider, 1 for the fastest
+ * counter clock */
+#ifndef PWM_CLOCK_HIRES_DIVIDER
+#define PWM_CLOCK_HIRES_DIVIDER         (1U)
+#endif
+
+/* Peripheral clock of the PWM counter */
+#define PWM_CLOCK_PCLK                  PCLK_TCPWM0_CLOCKS256
+
+/*******************************************************************************
+* Compare update engine (pwm_update.c)
+*******************************************************************************/
+/* Set to 1 to buffer the period as well, so the period can be changed at run
+ * time and swaps in together with its compare pair */
+#ifndef PWM_UPDATE_PERIOD_SWAP_ENABLE
+#define PWM_UPDATE_PERIOD_SWAP_ENABLE   (1)
+#endif
+
+/* Smallest period accepted at run time, in counter ticks */
+#define PWM_UPDATE_PERIOD_MIN           (16U)
+
+/* Largest period, limited by the 16-bit counters of TCPWM group 1 */
+#define PWM_UPDATE_PERIOD_MAX           (65535U)
+
+/* Slew rate at startup in Q16.16 counter ticks per period, 0 for none */
+#ifndef PWM_UPDATE_SLEW_DEFAULT
+#define PWM_UPDATE_SLEW_DEFAULT         (0U)
+#endif
+
+/* Set to 1 to let the commit ISR access the counter below through constant
+ * register addresses (pwm_regs.h) instead of the generic PDL functions */
+#ifndef PWM_UPDATE_STATIC_CHANNEL
+#define PWM_UPDATE_STATIC_CHANNEL       (1)
+#endif
+
+/* Counter passed to pwm_update_init(), as generated from the design file */
+#ifndef PWM_UPDATE_HW
+#define PWM_UPDATE_HW                   TCPWM0_GRP1_CNT0_HW
+#define PWM_UPDATE_NUM                  TCPWM0_GRP1_CNT0_NUM
+#endif
+
+/* Set to 1 to drive the complementary output (line_compl) and insert dead
+ * time, both updated through the buffered swap. The dead time buffer is
+ * exchanged with the period buffer, so this needs the period swap. */
+#ifndef PWM_UPDATE_DEAD_TIME_ENABLE
+#define PWM_UPDATE_DEAD_TIME_ENABLE     (0)
+#endif
+
+/* Largest dead time in counter clocks (DT_LINE_OUT_L field) */
+#define PWM_UPDATE_DEAD_TIME_MAX        (255U)
+
+#if (PWM_UPDATE_DEAD_TIME_ENABLE) && !(PWM_UPDATE_PERIOD_SWAP_ENABLE)
+#error "PWM_UPDATE_DEAD_TIME_ENABLE requires PWM_UPDATE_PERIOD_SWAP_ENABLE"
+#endif
+
+/* Set to 1 to let the commit ISR play an uploaded table of steps */
+#ifndef PWM_UPDATE_SEQUENCER_ENABLE
+#define PWM_UPDATE_SEQUENCER_ENABLE     (1)
+#endif
+
+/* Number of steps of the table uploaded through the binary protocol */
+#define PWM_UPDATE_SEQUENCE_MAX_STEPS   (32U)
+
+/*******************************************************************************
+* Idle handling (low_power.c)
+*******************************************************************************/
+/* Set to 1 to try DeepSleep before Sleep when idle. DeepSleep is only taken
+ * while the counter is stopped, as it stops clk_peri. */
+#ifndef LOW_POWER_DEEPSLEEP_ENABLE
+#define LOW_POWER_DEEPSLEEP_ENABLE      (0)
+#endif
+
+/* SysPm order of the DeepSleep callback, smallest is checked first */
+#define LOW_POWER_CALLBACK_ORDER        (0U)
+
+/*******************************************************************************
+* Deferred logging (app_log.c)
+*******************************************************************************/
+/* Queue size in bytes, must be a power of two and hold the longest burst of
+ * messages, such as the instructions banner */
+#ifndef APP_LOG_BUFFER_SIZE
+#define APP_LOG_BUFFER_SIZE             (1024)
+#endif
+
+/* Longest single formatted message including the terminator */
+#define APP_LOG_MESSAGE_SIZE            (128)
+
+/* Set to 1 to send through UART TX DMA instead of the TX FIFO interrupt */
+#ifndef APP_LOG_USE_DMA
+#define APP_LOG_USE_DMA                 (0)
+#endif
+
+/*******************************************************************************
+* Telemetry (telemetry.c)
+*******************************************************************************/
+/* Set to 1 to send a binary telemetry frame of the applied waveform at a
+ * decimation of the PWM rate. Enable APP_LOG_USE_DMA to send it by DMA. */
+#ifndef TELEMETRY_ENABLE
+#define TELEMETRY_ENABLE                (0)
+#endif
+
+/* PWM periods per telemetry frame at startup, 0 for off. 900 periods of the
+ * default 18 kHz PWM give 20 frames per second. */
+#ifndef TELEMETRY_DECIMATION
+#define TELEMETRY_DECIMATION            (900U)
+#endif
+
+/*******************************************************************************
+* Multi-channel PWM manager (pwm_channels.c)
+*******************************************************************************/
+/* Largest number of counters in one channel set, e.g. three inverter phases */
+#ifndef PWM_CHANNELS_MAX
+#define PWM_CHANNELS_MAX                (3)
+#endif
+
+/* The grouped swap is a software trigger of this all-counter trigger line,
+ * which is set up as the swap input of every channel. It must not be used by
+ * another feature for the same counters. */
+#ifndef PWM_CHANNELS_SWAP_TRIG_LINE
+#define PWM_CHANNELS_SWAP_TRIG_LINE     TRIG_OUT_MUX_5_TCPWM0_ALL_CNT_TR_IN4
+#define PWM_CHANNELS_SWAP_INPUT         CY_TCPWM_INPUT_TRIG(4U)
+#endif
+
+/* pwm_channels_start() raises this all-counter trigger line, the start input
+ * of every channel, so all counters start on the same clock cycle. It is
+ * kept apart from the swap line so that a commit can never restart a
+ * counter that was stopped. */
+#ifndef PWM_CHANNELS_START_TRIG_LINE
+#define PWM_CHANNELS_START_TRIG_LINE    TRIG_OUT_MUX_5_TCPWM0_ALL_CNT_TR_IN5
+#define PWM_CHANNELS_START_INPUT        CY_TCPWM_INPUT_TRIG(5U)
+#endif
+
+/*******************************************************************************
+* Latency instrumentation (latency_trace.c)
+*******************************************************************************/
+/* Set to 1 to timestamp the command path with the DWT cycle counter. The 'l'
+ * key then dumps the statistics. */
+#ifndef LATENCY_TRACE_ENABLE
+#define LATENCY_TRACE_ENABLE            (0)
+#endif
+
+/*******************************************************************************
+* Benchmark suite (bench.c)
+*******************************************************************************/
+/* Set by "make build BENCH=1" to run the benchmarks at startup */
+#ifndef BENCH_ENABLE
+#define BENCH_ENABLE                    (0)
+#endif
+
+/* Interrupt line not used by the application, pended from software to
+ * measure the interrupt entry and exit overhead */
+#ifndef BENCH_SW_IRQ
+#define BENCH_SW_IRQ                    tcpwm_0_interrupts_263_IRQn
+#endif
+
+/*******************************************************************************
+* DMA-fed compare streaming (pwm_stream.c)
+*******************************************************************************/
+/* Set to 1 to build the waveform table streaming engine */
+#ifndef PWM_STREAM_ENABLE
+#define PWM_STREAM_ENABLE               (0)
+#endif
+
+/* DataWire channel that copies one CC0/CC1 pair per PWM period */
+#ifndef PWM_STREAM_DW
+#define PWM_STREAM_DW                   DW0
+#define PWM_STREAM_DW_CHANNEL           (0UL)
+#define PWM_STREAM_DW_IRQ               cpuss_interrupts_dw0_0_IRQn
+#endif
+#define PWM_STREAM_DW_IRQ_PRIORITY      (2)
+
+/* Trigger routes: counter TC (tr_out0) to the DataWire channel, and DataWire
+ * completion back to the swap input of the counter. The names must match the
+ * trigger multiplexer of the selected device. */
+#ifndef PWM_STREAM_TC_TRIG_IN
+#define PWM_STREAM_TC_TRIG_IN           TRIG_IN_MUX_0_TCPWM0_TR_OUT0256
+#define PWM_STREAM_TC_TRIG_OUT          TRIG_OUT_MUX_0_PDMA0_TR_IN0
+#define PWM_STREAM_SWAP_TRIG_IN         TRIG_IN_MUX_5_PDMA0_TR_OUT0
+#define PWM_STREAM_SWAP_TRIG_OUT        TRIG_OUT_MUX_5_TCPWM0_ALL_CNT_TR_IN0
+#define PWM_STREAM_SWAP_INPUT           CY_TCPWM_INPUT_TRIG(0U)
+#endif
+
+/*******************************************************************************
+* PWM-synchronized current sampling (current_sense.c)
+*******************************************************************************/
+/* Set to 1 to sample the phase currents on every overflow of the counter */
+#ifndef CURRENT_SENSE_ENABLE
+#define CURRENT_SENSE_ENABLE            (0)
+#endif
+
+/* SAR channels scanned per trigger, e.g. two shunts of a three-phase
+ * inverter. Channel n samples SARMUX pin n. */
+#ifndef CURRENT_SENSE_CHANNELS
+#define CURRENT_SENSE_CHANNELS          (2U)
+#endif
+
+/* Sample sets per half of the circular buffer, at most 256. The callback
+ * runs once per half, so this is also the callback decimation. */
+#ifndef CURRENT_SENSE_SETS_PER_HALF
+#define CURRENT_SENSE_SETS_PER_HALF     (8U)
+#endif
+
+#define CURRENT_SENSE_SAR               SAR0
+#define CURRENT_SENSE_VREF_MV           (1650UL) /* VDDA / 2 at 3.3 V */
+#define CURRENT_SENSE_SAMPLE_CLOCKS     (4UL)
+
+/* Divider of the SAR clock: clk_peri / 4 = 18 MHz */
+#define CURRENT_SENSE_CLK_DIV_VALUE     (4UL)
+
+/* DataWire channel that empties the SAR result registers */
+#ifndef CURRENT_SENSE_DW
+#define CURRENT_SENSE_DW                DW0
+#define CURRENT_SENSE_DW_CHANNEL        (1UL)
+#define CURRENT_SENSE_DW_IRQ            cpuss_interrupts_dw0_1_IRQn
+#endif
+#define CURRENT_SENSE_DW_IRQ_PRIORITY   (2)
+
+/* Trigger routes: counter overflow (tr_out1) to the SAR start of scan, and
+ * SAR end of scan to the DataWire channel. The names must match the trigger
+ * multiplexer of the selected device. */
+#ifndef CURRENT_SENSE_SAR_TRIG_IN
+#define CURRENT_SENSE_SAR_TRIG_IN       TRIG_IN_MUX_6_TCPWM0_TR_OUT1256
+#define CURRENT_SENSE_SAR_TRIG_OUT      TRIG_OUT_MUX_6_PASS_TR_SAR_IN
+#define CURRENT_SENSE_EOS_TRIG_IN       TRIG_IN_MUX_0_PASS_TR_SAR_OUT
+#define CURRENT_SENSE_EOS_TRIG_OUT      TRIG_OUT_MUX_0_PDMA0_TR_IN1
+#endif
+
+/*******************************************************************************
+* Closed-loop duty regulation (pwm_regulator.c)
+*******************************************************************************/
+/* Set to 1 to regulate the duty cycle from the terminal count ISR with a PI
+ * controller on a channel of the PWM-synchronized current sampling */
+#ifndef PWM_REGULATOR_ENABLE
+#define PWM_REGULATOR_ENABLE            (0)
+#endif
+
+/* SAR channel of the measured quantity */
+#ifndef PWM_REGULATOR_CHANNEL
+#define PWM_REGULATOR_CHANNEL           (0U)
+#endif
+
+/* Gains at startup, Q8.8 fractions of the Q15 duty cycle per ADC count.
+ * Opcode 0x09 changes them at run time. */
+#ifndef PWM_REGULATOR_KP
+#define PWM_REGULATOR_KP                (256U)
+#define PWM_REGULATOR_KI                (16U)
+#endif
+
+/* Highest duty cycle the regulator applies, Q15 (95 %) */
+#ifndef PWM_REGULATOR_DUTY_MAX
+#define PWM_REGULATOR_DUTY_MAX          (31130)
+#endif
+
+/* Largest result of the 12-bit single-ended SAR scan */
+#define PWM_REGULATOR_MEASUREMENT_MAX   (4095U)
+
+#if (PWM_REGULATOR_ENABLE) && !(CURRENT_SENSE_ENABLE)
+#error "PWM_REGULATOR_ENABLE requires CURRENT_SENSE_ENABLE"
+#endif
+
+/*******************************************************************************
+* Capture companion (pwm_capture.c)
+*******************************************************************************/
+/* Set to 1 to measure an input signal with the neighbouring counter */
+#ifndef PWM_CAPTURE_ENABLE
+#define PWM_CAPTURE_ENABLE              (0)
+#endif
+
+/* Captured cycles per half of the circular buffer, at most 256 */
+#ifndef PWM_CAPTURE_SAMPLES_PER_HALF
+#define PWM_CAPTURE_SAMPLES_PER_HALF    (16U)
+#endif
+
+/* Capture counter, next to the PWM counter and clocked from its divider */
+#define PWM_CAPTURE_HW                  TCPWM0_GRP1_CNT0_HW
+#define PWM_CAPTURE_NUM                 (TCPWM0_GRP1_CNT0_NUM + 1UL)
+#define PWM_CAPTURE_PCLK                PCLK_TCPWM0_CLOCKS257
+#define PWM_CAPTURE_COUNTER_MASK        (0xFFFFUL) /* 16-bit counter */
+
+/* DataWire channel that empties the capture registers */
+#ifndef PWM_CAPTURE_DW
+#define PWM_CAPTURE_DW                  DW0
+#define PWM_CAPTURE_DW_CHANNEL          (2UL)
+#define PWM_CAPTURE_DW_IRQ              cpuss_interrupts_dw0_2_IRQn
+#endif
+#define PWM_CAPTURE_DW_IRQ_PRIORITY     (2)
+
+/* Input pin, P0.5 on the CY8CKIT-062S4. It must have the tr_io_input
+ * function of PWM_CAPTURE_INPUT_TRIG_IN on the selected device. */
+#ifndef PWM_CAPTURE_PORT
+#define PWM_CAPTURE_PORT                GPIO_PRT0
+#define PWM_CAPTURE_PIN                 (5U)
+#define PWM_CAPTURE_HSIOM               P0_5_PERI_TR_IO_INPUT1
+#endif
+
+/* Trigger routes: input pin to both capture inputs of the counter, and the
+ * falling edge capture (tr_out0 on CC1) to the DataWire channel. The names
+ * must match the trigger multiplexer of the selected device; for the
+ * loop-back test, wire the PWM output to the input pin. */
+#ifndef PWM_CAPTURE_INPUT_TRIG_IN
+#define PWM_CAPTURE_INPUT_TRIG_IN       TRIG_IN_MUX_5_HSIOM_TR_OUT1
+#define PWM_CAPTURE_INPUT_TRIG_OUT      TRIG_OUT_MUX_5_TCPWM0_ALL_CNT_TR_IN1
+#define PWM_CAPTURE_INPUT               CY_TCPWM_INPUT_TRIG(1U)
+#define PWM_CAPTURE_DMA_TRIG_IN         TRIG_IN_MUX_0_TCPWM0_TR_OUT0257
+#define PWM_CAPTURE_DMA_TRIG_OUT        TRIG_OUT_MUX_0_PDMA0_TR_IN2
+#endif
+
+/*******************************************************************************
+* Fault shutdown (pwm_fault.c)
+*******************************************************************************/
+/* Set to 1 to stop the counter in hardware on the fault pin */
+#ifndef PWM_FAULT_ENABLE
+#define PWM_FAULT_ENABLE                (0)
+#endif
+
+/* Fault pin, by default the user button CYBSP_USER_BTN (P0.4), active low */
+#ifndef PWM_FAULT_PORT
+#define PWM_FAULT_PORT                  GPIO_PRT0
+#define PWM_FAULT_PIN                   (4U)
+#define PWM_FAULT_HSIOM                 P0_4_PERI_TR_IO_INPUT0
+#define PWM_FAULT_IRQ                   ioss_interrupts_gpio_0_IRQn
+#endif
+#define PWM_FAULT_ACTIVE_LOW            (true)
+#define PWM_FAULT_IRQ_PRIORITY          (2)
+
+/* Trigger route of the fault pin to the kill input of the counter. The
+ * names must match the trigger multiplexer of the selected device. */
+#ifndef PWM_FAULT_TRIG_IN
+#define PWM_FAULT_TRIG_IN               TRIG_IN_MUX_5_HSIOM_TR_OUT0
+#define PWM_FAULT_TRIG_OUT              TRIG_OUT_MUX_5_TCPWM0_ALL_CNT_TR_IN2
+#define PWM_FAULT_INPUT                 CY_TCPWM_INPUT_TRIG(2U)
+#endif
+
+/*******************************************************************************
+* External sync input (pwm_sync.c)
+*******************************************************************************/
+/* Set to 1 to reload the counter and swap in new compare values on the edge
+ * of an external sync input instead of starting and swapping by software */
+#ifndef PWM_SYNC_ENABLE
+#define PWM_SYNC_ENABLE                 (0)
+#endif
+
+/* Sync pin. It must have a tr_io_input function on the selected device. */
+#ifndef PWM_SYNC_PORT
+#define PWM_SYNC_PORT                   GPIO_PRT1
+#define PWM_SYNC_PIN                    (0U)
+#define PWM_SYNC_HSIOM                  P1_0_PERI_TR_IO_INPUT2
+#endif
+
+/* Trigger route of the sync pin to the reload and swap inputs of the
+ * counter. The names must match the trigger multiplexer of the selected
+ * device. */
+#ifndef PWM_SYNC_TRIG_IN
+#define PWM_SYNC_TRIG_IN                TRIG_IN_MUX_5_HSIOM_TR_OUT2
+#define PWM_SYNC_TRIG_OUT               TRIG_OUT_MUX_5_TCPWM0_ALL_CNT_TR_IN3
+#define PWM_SYNC_INPUT                  CY_TCPWM_INPUT_TRIG(3U)
+#endif
+
+/*******************************************************************************
+* Split-core setpoint path (setpoint_ipc.c)
+*******************************************************************************/
+/* Set to 1 for the split-core configuration: the CM0+ owns the UART and
+ * sends validated setpoints through IPC, the CM4 only runs the PWM */
+#ifndef SETPOINT_IPC_ENABLE
+#define SETPOINT_IPC_ENABLE             (0)
+#endif
+
+/* IPC channel and interrupt structure of the setpoint mailbox. Both must be
+ * free for the application in the system configuration of both cores. */
+#ifndef SETPOINT_IPC_CHANNEL
+#define SETPOINT_IPC_CHANNEL            (CY_IPC_CHAN_USER)
+#define SETPOINT_IPC_INTR               (CY_IPC_INTR_USER)
+#endif
+
+#endif /* APP_CONFIG_H_ */
@@ -0,0 +1,269 @@
+/*******************************************************************************
+* File Name:   app_log.c
+*
+* Description: Deferred, non-blocking logging. Messages are formatted into
+* a ring buffer and sent by the asynchronous UART transfer in the background,
+* so the caller never waits for the serial line. Messages that do not fit are
+* dropped as a whole and counted.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2020-2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <stdarg.h>
+#include <stdio.h>
+#include "cy_pdl.h"
+#include "cyhal.h"
+#include "app_config.h"
+#include "ring_buffer.h"
+#include "app_log.h"
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+static cyhal_uart_t *log_uart = NULL; /* UART the log is sent through */
+static uint8_t log_storage[APP_LOG_BUFFER_SIZE]; /* Backing memory of queue */
+static ring_buffer_t log_queue; /* Formatted bytes waiting for transmission */
+static volatile uint32_t log_tx_length = 0U; /* Bytes of the transfer ongoing */
+static volatile uint32_t log_dropped = 0U; /* Messages lost on overflow */
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+static void app_log_kick(void);
+
+/*******************************************************************************
+* Function Name: app_log_init
+********************************************************************************
+* Summary:
+* Initializes the log queue. The owner of the UART callback must forward
+* CYHAL_UART_IRQ_TX_DONE events to app_log_tx_done().
+*
+* Parameters:
+*  uart - initialized UART object
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void app_log_init(cyhal_uart_t *uart)
+{
+    log_uart = uart;
+    ring_buffer_init(&log_queue, log_storage, sizeof(log_storage));
+    log_tx_length = 0U;
+    log_dropped = 0U;
+
+#if (APP_LOG_USE_DMA)
+    /* Let the asynchronous transfer run on DMA instead of the FIFO ISR */
+    if (CY_RSLT_SUCCESS != cyhal_uart_set_async_mode(uart, CYHAL_ASYNC_DMA,
+                                                     CYHAL_DMA_PRIORITY_DEFAULT))
+    {
+        CY_ASSERT(0);
+    }
+#endif
+}
+
+/*******************************************************************************
+* Function Name: app_log_printf
+********************************************************************************
+* Summary:
+* Formats a message and queues it for transmission. Returns without waiting
+* for the UART.
+*
+* Parameters:
+*  format - printf style format string
+*  ... - format arguments
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void app_log_printf(const char *format, ...)
+{
+    char message[APP_LOG_MESSAGE_SIZE];
+    va_list args;
+    int length;
+
+    va_start(args, format);
+    length = vsnprintf(message, sizeof(message), format, args);
+    va_end(args);
+
+    if (length < 0)
+    {
+        return;
+    }
+    if ((uint32_t)length >= sizeof(message))
+    {
+        length = (int)sizeof(message) - 1;
+    }
+
+    app_log_write(message, (uint32_t)length);
+}
+
+/*******************************************************************************
+* Function Name: app_log_write
+********************************************************************************
+* Summary:
+* Queues raw bytes for transmission. The bytes are stored completely or the
+* message is dropped and counted. The queue has a single producer, so this
+* function and app_log_printf() must only be called from the main loop. The
+* copy runs with interrupts enabled; only starting the transfer is
+* serialized with the TX-done interrupt.
+*
+* Parameters:
+*  data - bytes to send
+*  length - number of bytes
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void app_log_write(const char *data, uint32_t length)
+{
+    uint32_t saved_intr;
+    bool stored;
+
+    /* Single producer: the TX-done interrupt only consumes, so the copy
+     * needs no lock and never masks the terminal count ISR */
+    stored = ring_buffer_write(&log_queue, (const uint8_t *)data, length);
+
+    /* The drop count and the transfer are shared with the TX-done
+     * interrupt */
+    saved_intr = Cy_SysLib_EnterCriticalSection();
+    if (!stored)
+    {
+        log_dropped++;
+    }
+    app_log_kick();
+    Cy_SysLib_ExitCriticalSection(saved_intr);
+}
+
+/*******************************************************************************
+* Function Name: app_log_tx_done
+********************************************************************************
+* Summary:
+* Releases the bytes of the completed transfer and starts the next one. To be
+* called from the UART event callback on CYHAL_UART_IRQ_TX_DONE.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void app_log_tx_done(void)
+{
+    ring_buffer_consume(&log_queue, log_tx_length);
+    log_tx_length = 0U;
+    app_log_kick();
+}
+
+/*******************************************************************************
+* Function Name: app_log_flush
+********************************************************************************
+* Summary:
+* Waits until every queued message has been sent.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void app_log_flush(void)
+{
+    while (!ring_buffer_is_empty(&log_queue))
+    {
+    }
+}
+
+/*******************************************************************************
+* Function Name: app_log_get_dropped
+********************************************************************************
+* Summary:
+* Returns the number of messages dropped because the queue was full.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  uint32_t - dropped message count
+*
+*******************************************************************************/
+uint32_t app_log_get_dropped(void)
+{
+    return log_dropped;
+}
+
+/*******************************************************************************
+* Function Name: app_log_kick
+********************************************************************************
+* Summary:
+* Starts an asynchronous transfer of the longest contiguous run of queued
+* bytes if none is ongoing. Must be called with interrupts masked or from the
+* UART interrupt.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void app_log_kick(void)
+{
+    const uint8_t *data;
+    uint32_t length;
+
+    if (0U != log_tx_length)
+    {
+        return;
+    }
+
+    length = ring_buffer_peek_linear(&log_queue, &data);
+    if (0U != length)
+    {
+        log_tx_length = length;
+        if (CY_RSLT_SUCCESS != cyhal_uart_write_async(log_uart, (void *)data,
+                                                      length))
+        {
+            /* Drop the chunk rather than stall the queue */
+            log_tx_length = 0U;
+            ring_buffer_consume(&log_queue, length);
+            log_dropped++;
+        }
+    }
+}
@@ -0,0 +1,512 @@
+/*******************************************************************************
+* File Name:   bench.c
+*
+* Description: On-target benchmark suite, built with "make build BENCH=1".
+* Measures the cost of a dual compare update against the single compare
+* scheme that needs two updates per PWM cycle, the interrupt entry/exit
+* overhead, and the CPU load and sustainable update rate of the terminal
+* count commit for a range of periods. Results are printed as CSV lines
+* starting with "BENCH," so they can be compared across BSP/PDL versions.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2020-2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include "cy_pdl.h"
+#include "cybsp.h"
+#include "app_log.h"
+#include "pwm_update.h"
+#include "pwm_regs.h"
+#include "pwm_clock.h"
+#include "bench.h"
+
+#if (BENCH_ENABLE)
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define BENCH_ITERATIONS        (1000U)
+#define BENCH_WINDOW_MS         (20U)  /* Duration of one rate measurement */
+#define BENCH_SW_IRQ_PRIORITY   (0U)
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+typedef struct
+{
+    uint32_t count;
+    uint32_t min;
+    uint32_t max;
+    uint64_t sum;
+} bench_result_t;
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+static void bench_reset(bench_result_t *result);
+static void bench_add(bench_result_t *result, uint32_t cycles);
+static void bench_report(const char *name, uint32_t param,
+                         const bench_result_t *result);
+static uint32_t bench_overhead(void);
+static void bench_compare_update(TCPWM_Type *base, uint32_t cnt_num,
+                                 uint32_t overhead);
+static void bench_isr_overhead(uint32_t overhead);
+static void bench_update_rate(TCPWM_Type *base, uint32_t cnt_num);
+static uint32_t bench_spin(uint32_t cycles, uint32_t period);
+static void bench_sw_isr(void);
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+static volatile uint32_t isr_entry_cycles;
+
+/* Periods for the update rate sweep, in counter ticks. At 125 ticks the
+ * terminal count ISR runs every 500 CPU cycles of the default clocks;
+ * shorter periods would leave the CPU to the ISR alone. */
+static const uint32_t bench_periods[] = { 2000U, 1000U, 500U, 250U, 125U };
+
+/*******************************************************************************
+* Function Name: bench_run
+********************************************************************************
+* Summary:
+* Runs all workloads and prints the result table. The counter must be
+* running with the compare update engine initialized. The original period
+* and compare values are restored afterwards.
+*
+* Parameters:
+*  base - TCPWM block base address
+*  cnt_num - counter number within the block
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void bench_run(TCPWM_Type *base, uint32_t cnt_num)
+{
+    uint32_t overhead;
+
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    overhead = bench_overhead();
+
+    app_log_printf("BENCH,name,param,count,min,avg,max\r\n");
+    app_log_printf("BENCH,core_clock_hz,%lu,1,0,0,0\r\n",
+                   (unsigned long)SystemCoreClock);
+    app_log_printf("BENCH,ramfunc,%lu,1,0,0,0\r\n",
+                   (unsigned long)PWM_RAMFUNC_ENABLE);
+    app_log_flush();
+
+    bench_compare_update(base, cnt_num, overhead);
+    bench_isr_overhead(overhead);
+    bench_update_rate(base, cnt_num);
+
+    app_log_printf("BENCH,done,0,0,0,0,0\r\n");
+    app_log_flush();
+}
+
+/*******************************************************************************
+* Function Name: bench_compare_update
+********************************************************************************
+* Summary:
+* Measures one dual compare update (CC0 and CC1 buffer writes plus one swap)
+* against the single compare scheme, which needs a buffer write and a swap
+* twice per PWM cycle, and the same dual update through the constant register
+* addresses of pwm_regs.h for the counter of the configuration. The current
+* compare values are written back, so the output does not change.
+*
+* Parameters:
+*  base - TCPWM block base address
+*  cnt_num - counter number within the block
+*  overhead - cycles of an empty measurement
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void bench_compare_update(TCPWM_Type *base, uint32_t cnt_num,
+                                 uint32_t overhead)
+{
+    bench_result_t dual;
+    bench_result_t fixed;
+    bench_result_t single;
+    bench_result_t stage;
+    uint32_t compare0 = Cy_TCPWM_PWM_GetCompare0BufVal(base, cnt_num);
+    uint32_t compare1 = Cy_TCPWM_PWM_GetCompare1BufVal(base, cnt_num);
+    uint32_t saved_intr;
+    uint32_t start;
+    uint32_t i;
+
+    bench_reset(&dual);
+    bench_reset(&fixed);
+    bench_reset(&single);
+    bench_reset(&stage);
+
+    for (i = 0U; i < BENCH_ITERATIONS; i++)
+    {
+        saved_intr = Cy_SysLib_EnterCriticalSection();
+
+        start = DWT->CYCCNT;
+        Cy_TCPWM_PWM_SetCompare0BufVal(base, cnt_num, compare0);
+        Cy_TCPWM_PWM_SetCompare1BufVal(base, cnt_num, compare1);
+        Cy_TCPWM_TriggerCaptureOrSwap_Single(base, cnt_num);
+        bench_add(&dual, DWT->CYCCNT - start - overhead);
+
+        /* Single compare: one update at the overflow, one at the TC */
+        start = DWT->CYCCNT;
+        Cy_TCPWM_PWM_SetCompare0BufVal(base, cnt_num, compare0);
+        Cy_TCPWM_TriggerCaptureOrSwap_Single(base, cnt_num);
+        Cy_TCPWM_PWM_SetCompare0BufVal(base, cnt_num, compare0);
+        Cy_TCPWM_TriggerCaptureOrSwap_Single(base, cnt_num);
+        bench_add(&single, DWT->CYCCNT - start - overhead);
+
+        /* Same update through constant register addresses */
+        start = DWT->CYCCNT;
+        PWM_REGS_UPDATE(PWM_UPDATE_HW, PWM_UPDATE_NUM, compare0, compare1);
+        bench_add(&fixed, DWT->CYCCNT - start - overhead);
+
+        start = DWT->CYCCNT;
+        pwm_update_stage(compare0, compare1);
+        bench_add(&stage, DWT->CYCCNT - start - overhead);
+
+        Cy_SysLib_ExitCriticalSection(saved_intr);
+    }
+
+    bench_report("dual_compare_update", 0U, &dual);
+    bench_report("dual_compare_update_fixed", 0U, &fixed);
+    bench_report("single_compare_two_updates", 0U, &single);
+    bench_report("pwm_update_stage", 0U, &stage);
+}
+
+/*******************************************************************************
+* Function Name: bench_isr_overhead
+********************************************************************************
+* Summary:
+* Pends an otherwise unused interrupt from software and measures the cycles
+* from pending to the first instruction of the handler and from there back
+* to the interrupted code.
+*
+* Parameters:
+*  overhead - cycles of an empty measurement
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void bench_isr_overhead(uint32_t overhead)
+{
+    const cy_stc_sysint_t sw_irq_cfg =
+    {
+        .intrSrc = BENCH_SW_IRQ,
+        .intrPriority = BENCH_SW_IRQ_PRIORITY
+    };
+    bench_result_t entry;
+    bench_result_t exit;
+    uint32_t start;
+    uint32_t end;
+    uint32_t i;
+
+    bench_reset(&entry);
+    bench_reset(&exit);
+
+    if (CY_SYSINT_SUCCESS != Cy_SysInt_Init(&sw_irq_cfg, bench_sw_isr))
+    {
+        CY_ASSERT(0);
+    }
+    NVIC_EnableIRQ(sw_irq_cfg.intrSrc);
+
+    for (i = 0U; i < BENCH_ITERATIONS; i++)
+    {
+        start = DWT->CYCCNT;
+        NVIC_SetPendingIRQ(sw_irq_cfg.intrSrc);
+        __DSB();
+        __ISB();
+        end = DWT->CYCCNT;
+
+        bench_add(&entry, isr_entry_cycles - start);
+        bench_add(&exit, end - isr_entry_cycles - overhead);
+    }
+
+    NVIC_DisableIRQ(sw_irq_cfg.intrSrc);
+
+    bench_report("isr_entry", 0U, &entry);
+    bench_report("isr_exit", 0U, &exit);
+}
+
+/*******************************************************************************
+* Function Name: bench_update_rate
+********************************************************************************
+* Summary:
+* For each period of the sweep, keeps a new compare pair staged all the time
+* so the terminal count ISR commits once per period, then reports the
+* commits per second achieved and expected, and the CPU load of the commit
+* path. The load is the work the main loop loses when the terminal count
+* interrupt runs, against the same loop with the interrupt masked.
+*
+* Parameters:
+*  base - TCPWM block base address
+*  cnt_num - counter number within the block
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void bench_update_rate(TCPWM_Type *base, uint32_t cnt_num)
+{
+    uint32_t period0 = Cy_TCPWM_PWM_GetPeriod0(base, cnt_num);
+    uint32_t compare0 = Cy_TCPWM_PWM_GetCompare0BufVal(base, cnt_num);
+    uint32_t compare1 = Cy_TCPWM_PWM_GetCompare1BufVal(base, cnt_num);
+    uint32_t window = (SystemCoreClock / 1000U) * BENCH_WINDOW_MS;
+    uint32_t counter_hz = pwm_clock_get_hz();
+    uint32_t idle_work;
+    uint32_t busy_work;
+    uint32_t commits;
+    uint32_t expected;
+    uint32_t load_ppm;
+    uint32_t i;
+
+    for (i = 0U; i < (sizeof(bench_periods) / sizeof(bench_periods[0])); i++)
+    {
+#if !(PWM_UPDATE_PERIOD_SWAP_ENABLE)
+        Cy_TCPWM_PWM_SetPeriod0(base, cnt_num, bench_periods[i]);
+#endif
+        pwm_update_stage_period(bench_periods[i], bench_periods[i] / 2U,
+                                bench_periods[i] / 2U);
+        cyhal_system_delay_ms(1U);
+
+        /* Reference: the same loop with the terminal count ISR masked */
+        Cy_TCPWM_SetInterruptMask(base, cnt_num, 0U);
+        idle_work = bench_spin(window, bench_periods[i]);
+        Cy_TCPWM_ClearInterrupt(base, cnt_num, CY_TCPWM_INT_ON_TC);
+        Cy_TCPWM_SetInterruptMask(base, cnt_num, CY_TCPWM_INT_ON_TC);
+
+        commits = pwm_update_get_commit_count();
+        busy_work = bench_spin(window, bench_periods[i]);
+        commits = pwm_update_get_commit_count() - commits;
+
+        /* Up/down counting: one period is 2 * Period0 counter ticks */
+        expected = (uint32_t)(((uint64_t)counter_hz * BENCH_WINDOW_MS) /
+                              (2000ULL * bench_periods[i]));
+        load_ppm = (busy_work >= idle_work) ? 0U :
+                   (uint32_t)(((uint64_t)(idle_work - busy_work) * 1000000ULL) /
+                              idle_work);
+
+        app_log_printf("BENCH,commits_per_s,%lu,%lu,0,%lu,%lu\r\n",
+                       (unsigned long)bench_periods[i],
+                       (unsigned long)commits,
+                       (unsigned long)((commits * 1000U) / BENCH_WINDOW_MS),
+                       (unsigned long)((expected * 1000U) / BENCH_WINDOW_MS));
+        app_log_printf("BENCH,commit_load_ppm,%lu,1,0,%lu,0\r\n",
+                       (unsigned long)bench_periods[i],
+                       (unsigned long)load_ppm);
+        app_log_flush();
+    }
+
+    /* Restore the design settings */
+#if !(PWM_UPDATE_PERIOD_SWAP_ENABLE)
+    Cy_TCPWM_PWM_SetPeriod0(base, cnt_num, period0);
+#endif
+    pwm_update_stage_period(period0, compare0, compare1);
+}
+
+/*******************************************************************************
+* Function Name: bench_spin
+********************************************************************************
+* Summary:
+* Keeps a compare pair staged in a loop for the given number of cycles, so
+* every terminal count commits. The staged pairs alternate between a 50 %
+* pulse and the same pulse moved by one tick, so the duty cycle of the
+* output does not change.
+*
+* Parameters:
+*  cycles - duration of the loop in CPU cycles
+*  period - period of the staged pairs
+*
+* Return:
+*  uint32_t - number of loop iterations completed
+*
+*******************************************************************************/
+static uint32_t bench_spin(uint32_t cycles, uint32_t period)
+{
+    uint32_t start = DWT->CYCCNT;
+    uint32_t iterations = 0U;
+    uint32_t compare = 0U;
+    uint32_t half = period / 2U;
+
+    while ((DWT->CYCCNT - start) < cycles)
+    {
+        compare ^= 1U;
+        pwm_update_stage(half + compare, half - compare);
+        iterations++;
+    }
+
+    return iterations;
+}
+
+/*******************************************************************************
+* Function Name: bench_overhead
+********************************************************************************
+* Summary:
+* Measures the cycles of two back-to-back cycle counter reads, which are
+* subtracted from every result.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  uint32_t - smallest measurement overhead in cycles
+*
+*******************************************************************************/
+static uint32_t bench_overhead(void)
+{
+    uint32_t best = UINT32_MAX;
+    uint32_t start;
+    uint32_t cycles;
+    uint32_t i;
+
+    for (i = 0U; i < 16U; i++)
+    {
+        start = DWT->CYCCNT;
+        cycles = DWT->CYCCNT - start;
+        if (cycles < best)
+        {
+            best = cycles;
+        }
+    }
+
+    return best;
+}
+
+/*******************************************************************************
+* Function Name: bench_sw_isr
+********************************************************************************
+* Summary:
+* Handler of the software pended interrupt. Only takes a timestamp.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void bench_sw_isr(void)
+{
+    isr_entry_cycles = DWT->CYCCNT;
+}
+
+/*******************************************************************************
+* Function Name: bench_reset
+********************************************************************************
+* Summary:
+* Clears a result accumulator.
+*
+* Parameters:
+*  result - accumulator
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void bench_reset(bench_result_t *result)
+{
+    result->count = 0U;
+    result->min = UINT32_MAX;
+    result->max = 0U;
+    result->sum = 0U;
+}
+
+/*******************************************************************************
+* Function Name: bench_add
+********************************************************************************
+* Summary:
+* Adds one measurement to a result accumulator.
+*
+* Parameters:
+*  result - accumulator
+*  cycles - measured cycles
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void bench_add(bench_result_t *result, uint32_t cycles)
+{
+    /* Guard against the overhead correction wrapping around */
+    if (cycles > 0x80000000UL)
+    {
+        cycles = 0U;
+    }
+
+    result->count++;
+    result->sum += cycles;
+    if (cycles < result->min)
+    {
+        result->min = cycles;
+    }
+    if (cycles > result->max)
+    {
+        result->max = cycles;
+    }
+}
+
+/*******************************************************************************
+* Function Name: bench_report
+********************************************************************************
+* Summary:
+* Prints one result line of the table.
+*
+* Parameters:
+*  name - workload name
+*  param - workload parameter, 0 if none
+*  result - accumulator
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void bench_report(const char *name, uint32_t param,
+                         const bench_result_t *result)
+{
+    uint32_t avg = (0U == result->count) ? 0U :
+                   (uint32_t)(result->sum / result->count);
+
+    app_log_printf("BENCH,%s,%lu,%lu,%lu,%lu,%lu\r\n", name,
+                   (unsigned long)param, (unsigned long)result->count,
+                   (unsigned long)((0U == result->count) ? 0U : result->min),
+                   (unsigned long)avg, (unsigned long)result->max);
+    app_log_flush();
+}
+
+#endif /* BENCH_ENABLE */
@@ -0,0 +1,59 @@
+/*******************************************************************************
+* File Name:   bench.h
+*
+* Description: On-target benchmark suite, built with "make build BENCH=1".
+* Measures the cost of a dual compare update against the single compare
+* scheme that needs two updates per PWM cycle, the interrupt entry/exit
+* overhead, and the CPU load and sustainable update rate of the terminal
+* count commit for a range of periods. Results are printed as CSV lines
+* starting with "BENCH," so they can be compared across BSP/PDL versions.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2020-2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef BENCH_H_
+#define BENCH_H_
+
+#include "cy_pdl.h"
+#include "app_config.h"
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+#if (BENCH_ENABLE)
+void bench_run(TCPWM_Type *base, uint32_t cnt_num);
+#endif
+
+#endif /* BENCH_H_ */
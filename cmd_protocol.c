@@ -0,0 +1,419 @@
+/*******************************************************************************
+* File Name:   cmd_protocol.c
+*
+* Description: Binary framed command protocol. A frame carries absolute
+* or relative CC0/CC1 setpoints or a new period, protected by a CRC, so a
+* host can set an arbitrary waveform in a single message. Frames are parsed
+* one byte at a time in the RX path; bytes outside of a frame are passed back
+* as single-key commands.
+*
+* Frame layout (multi-byte fields are little endian):
+*   SYNC (0xA5) | OPCODE | LENGTH | PAYLOAD[LENGTH] | CRC16
+* The CRC is CRC-16/CCITT-FALSE over OPCODE, LENGTH and PAYLOAD. Every frame
+* is answered with a response frame whose opcode has bit 7 set and whose
+* payload is one status byte.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2020-2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include "pwm_port.h"
+#include "cmd_protocol.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define CRC16_INIT              (0xFFFFU)
+#define CRC16_POLY              (0x1021U)
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+typedef enum
+{
+    PARSER_IDLE,
+    PARSER_OPCODE,
+    PARSER_LENGTH,
+    PARSER_PAYLOAD,
+    PARSER_CRC_LOW,
+    PARSER_CRC_HIGH,
+    PARSER_DISCARD
+} parser_state_t;
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+static cmd_protocol_result_t cmd_protocol_decode(cmd_protocol_command_t *command);
+static uint16_t cmd_protocol_field(uint32_t offset);
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+static parser_state_t parser_state = PARSER_IDLE;
+static uint8_t frame_opcode;
+static uint8_t frame_length;
+static uint8_t frame_index;
+static uint8_t frame_payload[CMD_PROTOCOL_MAX_PAYLOAD];
+static uint16_t frame_crc;
+static uint16_t received_crc;
+static uint32_t discard_count; /* Bytes left of a frame with a bad length */
+
+/*******************************************************************************
+* Function Name: cmd_protocol_reset
+********************************************************************************
+* Summary:
+* Discards any partially received frame.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void cmd_protocol_reset(void)
+{
+    parser_state = PARSER_IDLE;
+}
+
+/*******************************************************************************
+* Function Name: cmd_protocol_feed
+********************************************************************************
+* Summary:
+* Advances the frame parser by one received byte. The payload and CRC of a
+* frame with a length beyond CMD_PROTOCOL_MAX_PAYLOAD are skipped, so they
+* are not taken as single-key commands.
+*
+* Parameters:
+*  value - received byte
+*  command - filled in when a frame completes
+*
+* Return:
+*  cmd_protocol_result_t - what the byte completed
+*
+*******************************************************************************/
+cmd_protocol_result_t cmd_protocol_feed(uint8_t value,
+                                        cmd_protocol_command_t *command)
+{
+    cmd_protocol_result_t result = CMD_PROTOCOL_PENDING;
+
+    switch (parser_state)
+    {
+        case PARSER_IDLE:
+            if (CMD_PROTOCOL_SYNC == value)
+            {
+                frame_crc = CRC16_INIT;
+                parser_state = PARSER_OPCODE;
+            }
+            else
+            {
+                result = CMD_PROTOCOL_KEY;
+            }
+            break;
+        case PARSER_OPCODE:
+            frame_opcode = value;
+            frame_crc = cmd_protocol_crc16(frame_crc, value);
+            parser_state = PARSER_LENGTH;
+            break;
+        case PARSER_LENGTH:
+            frame_length = value;
+            frame_index = 0U;
+            frame_crc = cmd_protocol_crc16(frame_crc, value);
+            if (frame_length > CMD_PROTOCOL_MAX_PAYLOAD)
+            {
+                command->opcode = frame_opcode;
+                command->status = CMD_PROTOCOL_STATUS_BAD_LENGTH;
+                discard_count = (uint32_t)frame_length + 2U;
+                parser_state = PARSER_DISCARD;
+                result = CMD_PROTOCOL_ERROR;
+            }
+            else
+            {
+                parser_state = (0U == frame_length) ? PARSER_CRC_LOW :
+                                                      PARSER_PAYLOAD;
+            }
+            break;
+        case PARSER_PAYLOAD:
+            frame_payload[frame_index++] = value;
+            frame_crc = cmd_protocol_crc16(frame_crc, value);
+            if (frame_index == frame_length)
+            {
+                parser_state = PARSER_CRC_LOW;
+            }
+            break;
+        case PARSER_CRC_LOW:
+            received_crc = value;
+            parser_state = PARSER_CRC_HIGH;
+            break;
+        case PARSER_CRC_HIGH:
+            received_crc |= (uint16_t)((uint16_t)value << 8U);
+            parser_state = PARSER_IDLE;
+            command->opcode = frame_opcode;
+            if (received_crc != frame_crc)
+            {
+                command->status = CMD_PROTOCOL_STATUS_BAD_CRC;
+                result = CMD_PROTOCOL_ERROR;
+            }
+            else
+            {
+                result = cmd_protocol_decode(command);
+            }
+            break;
+        case PARSER_DISCARD:
+            if (0U == --discard_count)
+            {
+                parser_state = PARSER_IDLE;
+            }
+            break;
+        default:
+            parser_state = PARSER_IDLE;
+            break;
+    }
+
+    return result;
+}
+
+/*******************************************************************************
+* Function Name: cmd_protocol_build_response
+********************************************************************************
+* Summary:
+* Builds the response frame for a received command.
+*
+* Parameters:
+*  opcode - opcode of the received frame
+*  status - outcome of the command
+*  frame - output buffer of at least 6 bytes
+*
+* Return:
+*  uint32_t - frame length in bytes
+*
+*******************************************************************************/
+uint32_t cmd_protocol_build_response(uint8_t opcode,
+                                     cmd_protocol_status_t status,
+                                     uint8_t *frame)
+{
+    uint8_t payload = (uint8_t)status;
+
+    return cmd_protocol_build_frame(opcode, &payload, 1U, frame);
+}
+
+/*******************************************************************************
+* Function Name: cmd_protocol_build_frame
+********************************************************************************
+* Summary:
+* Builds a frame sent by the device, such as a response or a telemetry frame.
+* The response flag is set in the opcode.
+*
+* Parameters:
+*  opcode - opcode of the frame, without the response flag
+*  payload - payload bytes
+*  length - payload length, at most 255
+*  frame - output buffer of at least length + CMD_PROTOCOL_FRAME_OVERHEAD
+*          bytes
+*
+* Return:
+*  uint32_t - frame length in bytes
+*
+*******************************************************************************/
+uint32_t cmd_protocol_build_frame(uint8_t opcode, const uint8_t *payload,
+                                  uint32_t length, uint8_t *frame)
+{
+    uint16_t crc = CRC16_INIT;
+    uint32_t i;
+
+    frame[0] = CMD_PROTOCOL_SYNC;
+    frame[1] = opcode | CMD_PROTOCOL_RESPONSE_FLAG;
+    frame[2] = (uint8_t)length;
+    for (i = 0U; i < length; i++)
+    {
+        frame[3U + i] = payload[i];
+    }
+    for (i = 1U; i < (3U + length); i++)
+    {
+        crc = cmd_protocol_crc16(crc, frame[i]);
+    }
+    frame[3U + length] = (uint8_t)(crc & 0xFFU);
+    frame[4U + length] = (uint8_t)(crc >> 8U);
+
+    return length + CMD_PROTOCOL_FRAME_OVERHEAD;
+}
+
+/*******************************************************************************
+* Function Name: cmd_protocol_crc16
+********************************************************************************
+* Summary:
+* Updates a CRC-16/CCITT-FALSE with one byte.
+*
+* Parameters:
+*  crc - current CRC value
+*  value - next byte
+*
+* Return:
+*  uint16_t - updated CRC value
+*
+*******************************************************************************/
+uint16_t cmd_protocol_crc16(uint16_t crc, uint8_t value)
+{
+    uint32_t bit;
+
+    crc ^= (uint16_t)((uint16_t)value << 8U);
+    for (bit = 0U; bit < 8U; bit++)
+    {
+        crc = (0U != (crc & 0x8000U)) ?
+              (uint16_t)((uint16_t)(crc << 1U) ^ CRC16_POLY) :
+              (uint16_t)(crc << 1U);
+    }
+
+    return crc;
+}
+
+/*******************************************************************************
+* Function Name: cmd_protocol_decode
+********************************************************************************
+* Summary:
+* Decodes the payload of a frame that passed the CRC check.
+*
+* Parameters:
+*  command - decoded command
+*
+* Return:
+*  cmd_protocol_result_t - CMD_PROTOCOL_FRAME or CMD_PROTOCOL_ERROR
+*
+*******************************************************************************/
+static cmd_protocol_result_t cmd_protocol_decode(cmd_protocol_command_t *command)
+{
+    uint16_t field0 = cmd_protocol_field(0U);
+    uint16_t field1 = cmd_protocol_field(2U);
+
+    command->status = CMD_PROTOCOL_STATUS_OK;
+    command->value2 = 0;
+    command->value3 = 0;
+    command->index = 0U;
+
+    switch (frame_opcode)
+    {
+        case CMD_PROTOCOL_OP_SET_ABSOLUTE:
+            command->value0 = (int32_t)field0;
+            command->value1 = (int32_t)field1;
+            if (6U == frame_length)
+            {
+                /* Optional period, applied together with the pair */
+                command->value2 = (int32_t)cmd_protocol_field(4U);
+            }
+            else if (4U != frame_length)
+            {
+                command->status = CMD_PROTOCOL_STATUS_BAD_LENGTH;
+            }
+            break;
+        case CMD_PROTOCOL_OP_SET_RELATIVE:
+            command->value0 = (int32_t)(int16_t)field0;
+            command->value1 = (int32_t)(int16_t)field1;
+            if (4U != frame_length)
+            {
+                command->status = CMD_PROTOCOL_STATUS_BAD_LENGTH;
+            }
+            break;
+        case CMD_PROTOCOL_OP_SET_PERIOD:
+            command->value0 = (int32_t)field0;
+            command->value1 = 0;
+            if (2U != frame_length)
+            {
+                command->status = CMD_PROTOCOL_STATUS_BAD_LENGTH;
+            }
+            break;
+        case CMD_PROTOCOL_OP_SET_SLEW:
+        case CMD_PROTOCOL_OP_TLM_RATE:
+            command->value0 = (int32_t)field0;
+            command->value1 = 0;
+            if (2U != frame_length)
+            {
+                command->status = CMD_PROTOCOL_STATUS_BAD_LENGTH;
+            }
+            break;
+        case CMD_PROTOCOL_OP_SEQ_STEP:
+            command->index = frame_payload[0];
+            command->value0 = (int32_t)cmd_protocol_field(1U);
+            command->value1 = (int32_t)cmd_protocol_field(3U);
+            command->value2 = (int32_t)cmd_protocol_field(5U);
+            command->value3 = (int32_t)cmd_protocol_field(7U);
+            if (9U != frame_length)
+            {
+                command->status = CMD_PROTOCOL_STATUS_BAD_LENGTH;
+            }
+            break;
+        case CMD_PROTOCOL_OP_SEQ_RUN:
+        case CMD_PROTOCOL_OP_REG_GAINS:
+        case CMD_PROTOCOL_OP_REG_RUN:
+            command->value0 = (int32_t)field0;
+            command->value1 = (int32_t)field1;
+            if (4U != frame_length)
+            {
+                command->status = CMD_PROTOCOL_STATUS_BAD_LENGTH;
+            }
+            break;
+        case CMD_PROTOCOL_OP_SET_OUTPUT:
+            command->value0 = (int32_t)field0;
+            command->value1 = (int32_t)frame_payload[2];
+            if (3U != frame_length)
+            {
+                command->status = CMD_PROTOCOL_STATUS_BAD_LENGTH;
+            }
+            break;
+        default:
+            command->status = CMD_PROTOCOL_STATUS_UNSUPPORTED;
+            break;
+    }
+
+    return (CMD_PROTOCOL_STATUS_OK == command->status) ? CMD_PROTOCOL_FRAME :
+                                                         CMD_PROTOCOL_ERROR;
+}
+
+/*******************************************************************************
+* Function Name: cmd_protocol_field
+********************************************************************************
+* Summary:
+* Reads a little-endian 16-bit field of the received payload.
+*
+* Parameters:
+*  offset - byte offset of the field, at most CMD_PROTOCOL_MAX_PAYLOAD - 2
+*
+* Return:
+*  uint16_t - field value
+*
+*******************************************************************************/
+static uint16_t cmd_protocol_field(uint32_t offset)
+{
+    return (uint16_t)(frame_payload[offset] |
+                      ((uint16_t)frame_payload[offset + 1U] << 8U));
+}
@@ -0,0 +1,128 @@
+/*******************************************************************************
+* File Name:   cmd_protocol.h
+*
+* Description: Binary framed command protocol. A frame carries absolute
+* or relative CC0/CC1 setpoints or a new period, protected by a CRC, so a
+* host can set an arbitrary waveform in a single message. Frames are parsed
+* one byte at a time in the RX path; bytes outside of a frame are passed back
+* as single-key commands.
+*
+* Frame layout (multi-byte fields are little endian):
+*   SYNC (0xA5) | OPCODE | LENGTH | PAYLOAD[LENGTH] | CRC16
+* The CRC is CRC-16/CCITT-FALSE over OPCODE, LENGTH and PAYLOAD. Every frame
+* is answered with a response frame whose opcode has bit 7 set and whose
+* payload is one status byte.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2020-2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef CMD_PROTOCOL_H_
+#define CMD_PROTOCOL_H_
+
+#include "pwm_port.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define CMD_PROTOCOL_SYNC           (0xA5U)
+#define CMD_PROTOCOL_MAX_PAYLOAD    (12U)
+#define CMD_PROTOCOL_RESPONSE_FLAG  (0x80U)
+#define CMD_PROTOCOL_FRAME_OVERHEAD (5U) /* Sync, opcode, length and CRC */
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+typedef enum
+{
+    CMD_PROTOCOL_OP_SET_ABSOLUTE = 0x01U, /* u16 CC0, u16 CC1 [, u16 period] */
+    CMD_PROTOCOL_OP_SET_RELATIVE = 0x02U, /* s16 CC0 delta, s16 CC1 delta */
+    CMD_PROTOCOL_OP_SET_PERIOD   = 0x03U, /* u16 period */
+    CMD_PROTOCOL_OP_SET_OUTPUT   = 0x04U, /* u16 dead time, u8 complementary */
+    CMD_PROTOCOL_OP_SET_SLEW     = 0x05U, /* u16 ticks per period, Q8.8 */
+    CMD_PROTOCOL_OP_SEQ_STEP     = 0x06U, /* u8 index, u16 CC0, u16 CC1,
+                                           * u16 period, u16 dwell */
+    CMD_PROTOCOL_OP_SEQ_RUN      = 0x07U, /* u16 steps, u16 repeat */
+    CMD_PROTOCOL_OP_TLM_RATE     = 0x08U, /* u16 decimation */
+    CMD_PROTOCOL_OP_REG_GAINS    = 0x09U, /* u16 Kp, u16 Ki, Q8.8 */
+    CMD_PROTOCOL_OP_REG_RUN      = 0x0AU, /* u16 setpoint, u16 run */
+    CMD_PROTOCOL_OP_TELEMETRY    = 0x10U  /* Sent by the device only */
+} cmd_protocol_opcode_t;
+
+typedef enum
+{
+    CMD_PROTOCOL_STATUS_OK          = 0x00U,
+    CMD_PROTOCOL_STATUS_CLAMPED     = 0x01U, /* Applied, limited to period */
+    CMD_PROTOCOL_STATUS_BAD_CRC     = 0x02U,
+    CMD_PROTOCOL_STATUS_BAD_LENGTH  = 0x03U,
+    CMD_PROTOCOL_STATUS_UNSUPPORTED = 0x04U
+} cmd_protocol_status_t;
+
+typedef enum
+{
+    CMD_PROTOCOL_PENDING, /* Byte consumed, frame not complete yet */
+    CMD_PROTOCOL_KEY,     /* Byte is not part of a frame */
+    CMD_PROTOCOL_FRAME,   /* A valid frame was decoded */
+    CMD_PROTOCOL_ERROR    /* A frame was discarded */
+} cmd_protocol_result_t;
+
+typedef struct
+{
+    uint8_t opcode;                /* cmd_protocol_opcode_t */
+    int32_t value0;                /* CC0, CC0 delta, period, dead time,
+                                    * slew rate, step count, decimation,
+                                    * Kp or setpoint */
+    int32_t value1;                /* CC1, CC1 delta, complementary, repeat
+                                    * count, Ki or run */
+    int32_t value2;                /* Sequence step period, or the period of
+                                    * SET_ABSOLUTE (0 if not sent) */
+    int32_t value3;                /* Sequence step dwell */
+    uint8_t index;                 /* Sequence step index */
+    cmd_protocol_status_t status;  /* Reason when the frame was discarded */
+} cmd_protocol_command_t;
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+void cmd_protocol_reset(void);
+cmd_protocol_result_t cmd_protocol_feed(uint8_t value,
+                                        cmd_protocol_command_t *command);
+uint32_t cmd_protocol_build_response(uint8_t opcode,
+                                     cmd_protocol_status_t status,
+                                     uint8_t *frame);
+uint32_t cmd_protocol_build_frame(uint8_t opcode, const uint8_t *payload,
+                                  uint32_t length, uint8_t *frame);
+uint16_t cmd_protocol_crc16(uint16_t crc, uint8_t value);
+
+#endif /* CMD_PROTOCOL_H_ */
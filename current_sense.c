@@ -0,0 +1,422 @@
+/*******************************************************************************
+* File Name:   current_sense.c
+*
+* Description: Zero-CPU current sampling synchronized to the PWM. The
+* overflow trigger output (tr_out1) of the counter starts a SAR ADC scan at
+* the peak of every PWM period, and the end-of-scan trigger of the SAR starts
+* a DataWire channel that copies the channel results into a circular buffer.
+* The buffer is split into two halves; the application is called back only
+* when a half holds complete sample sets.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2020-2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include "cy_pdl.h"
+#include "cyhal.h"
+#include "cybsp.h"
+#include "app_config.h"
+#include "current_sense.h"
+
+#if (CURRENT_SENSE_ENABLE)
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+/* Channels enabled in the scan, starting from channel 0 */
+#define CURRENT_SENSE_CHAN_MASK ((1UL << CURRENT_SENSE_CHANNELS) - 1UL)
+
+/* Sample time of every channel, in SAR clock cycles */
+#define CURRENT_SENSE_SAMPLE_TIME \
+            (_VAL2FLD(SAR_SAMPLE_TIME01_SAMPLE_TIME0, \
+                      CURRENT_SENSE_SAMPLE_CLOCKS) | \
+             _VAL2FLD(SAR_SAMPLE_TIME01_SAMPLE_TIME1, \
+                      CURRENT_SENSE_SAMPLE_CLOCKS))
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+static void current_sense_sar_init(void);
+static void current_sense_descriptor_init(uint32_t half);
+static void current_sense_dma_isr(void);
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+/* Circular buffer written by the DMA, first half then second half */
+static current_sense_set_t sample_ring[2U * CURRENT_SENSE_SETS_PER_HALF];
+static cy_stc_dma_descriptor_t sample_descriptor[2]; /* One per half */
+static current_sense_callback_t sample_callback = NULL;
+static void *sample_callback_arg = NULL;
+static uint32_t expected_half = 0U; /* Half expected to complete next */
+static volatile uint32_t overrun_count = 0U;
+static cyhal_clock_t sar_clock; /* Divider feeding the SAR clock */
+
+/*******************************************************************************
+* Function Name: current_sense_init
+********************************************************************************
+* Summary:
+* Configures the SAR ADC for hardware triggered scans, sets up the DataWire
+* channel that empties the result registers into the circular buffer, and
+* connects the trigger routes counter tr_out1 -> SAR -> DataWire. Sampling
+* starts with current_sense_start().
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void current_sense_init(void)
+{
+    const cy_stc_sysint_t dma_irq_cfg =
+    {
+        .intrSrc = CURRENT_SENSE_DW_IRQ,
+        .intrPriority = CURRENT_SENSE_DW_IRQ_PRIORITY
+    };
+    const cy_stc_dma_channel_config_t channel_config =
+    {
+        .descriptor = &sample_descriptor[0],
+        .preemptable = false,
+        .priority = 0U,
+        .enable = false,
+        .bufferable = false
+    };
+
+    current_sense_sar_init();
+
+    current_sense_descriptor_init(0U);
+    current_sense_descriptor_init(1U);
+    Cy_DMA_Enable(CURRENT_SENSE_DW);
+    if (CY_DMA_SUCCESS != Cy_DMA_Channel_Init(CURRENT_SENSE_DW,
+                                              CURRENT_SENSE_DW_CHANNEL,
+                                              &channel_config))
+    {
+        CY_ASSERT(0);
+    }
+    Cy_DMA_Channel_SetInterruptMask(CURRENT_SENSE_DW, CURRENT_SENSE_DW_CHANNEL,
+                                    CY_DMA_INTR_MASK);
+
+    if (CY_SYSINT_SUCCESS != Cy_SysInt_Init(&dma_irq_cfg,
+                                            current_sense_dma_isr))
+    {
+        CY_ASSERT(0);
+    }
+    NVIC_EnableIRQ(dma_irq_cfg.intrSrc);
+
+    /* tr_out1 -> SAR scan, SAR end of scan -> DMA request */
+    if ((CY_RSLT_SUCCESS != Cy_TrigMux_Connect(CURRENT_SENSE_SAR_TRIG_IN,
+                                               CURRENT_SENSE_SAR_TRIG_OUT,
+                                               false, TRIGGER_TYPE_EDGE)) ||
+        (CY_RSLT_SUCCESS != Cy_TrigMux_Connect(CURRENT_SENSE_EOS_TRIG_IN,
+                                               CURRENT_SENSE_EOS_TRIG_OUT,
+                                               false, TRIGGER_TYPE_EDGE)))
+    {
+        CY_ASSERT(0);
+    }
+}
+
+/*******************************************************************************
+* Function Name: current_sense_register_callback
+********************************************************************************
+* Summary:
+* Registers the function called each time a half of the circular buffer
+* holds complete sample sets.
+*
+* Parameters:
+*  callback - function to call, NULL to disable
+*  callback_arg - argument passed to the callback
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void current_sense_register_callback(current_sense_callback_t callback,
+                                     void *callback_arg)
+{
+    sample_callback = NULL;
+    __DMB();
+    sample_callback_arg = callback_arg;
+    __DMB();
+    sample_callback = callback;
+}
+
+/*******************************************************************************
+* Function Name: current_sense_start
+********************************************************************************
+* Summary:
+* Enables the DataWire channel and the SAR ADC. The first scan starts at the
+* next overflow of the counter.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void current_sense_start(void)
+{
+    expected_half = 0U;
+    Cy_DMA_Channel_SetDescriptor(CURRENT_SENSE_DW, CURRENT_SENSE_DW_CHANNEL,
+                                 &sample_descriptor[0]);
+    Cy_DMA_Channel_Enable(CURRENT_SENSE_DW, CURRENT_SENSE_DW_CHANNEL);
+    Cy_SAR_Enable(CURRENT_SENSE_SAR);
+}
+
+/*******************************************************************************
+* Function Name: current_sense_stop
+********************************************************************************
+* Summary:
+* Disables the SAR ADC and the DataWire channel. A partly filled half is
+* discarded.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void current_sense_stop(void)
+{
+    Cy_SAR_Disable(CURRENT_SENSE_SAR);
+    Cy_DMA_Channel_Disable(CURRENT_SENSE_DW, CURRENT_SENSE_DW_CHANNEL);
+}
+
+/*******************************************************************************
+* Function Name: current_sense_get_overrun_count
+********************************************************************************
+* Summary:
+* Returns how many completed halves were not reported because the DMA
+* interrupt was held off for longer than one half.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  uint32_t - number of lost halves since startup
+*
+*******************************************************************************/
+uint32_t current_sense_get_overrun_count(void)
+{
+    return overrun_count;
+}
+
+/*******************************************************************************
+* Function Name: current_sense_sar_init
+********************************************************************************
+* Summary:
+* Clocks the SAR ADC and configures a single-ended scan of the first
+* CURRENT_SENSE_CHANNELS SARMUX pins, started by the hardware trigger. The
+* end-of-scan trigger output is enabled and all SAR interrupts are masked, as
+* the results are collected by the DMA only.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void current_sense_sar_init(void)
+{
+    cy_stc_sar_config_t sar_config =
+    {
+        .ctrl = (uint32_t)CY_SAR_VREF_PWR_100 |
+                (uint32_t)CY_SAR_VREF_SEL_VDDA_DIV_2 |
+                (uint32_t)CY_SAR_BYPASS_CAP_DISABLE |
+                (uint32_t)CY_SAR_NEG_SEL_VSSA_KELVIN |
+                (uint32_t)CY_SAR_CTRL_NEGVREF_HW |
+                (uint32_t)CY_SAR_CTRL_COMP_DLY_12 |
+                (uint32_t)CY_SAR_COMP_PWR_100 |
+                (uint32_t)CY_SAR_DEEPSLEEP_SARMUX_OFF |
+                (uint32_t)CY_SAR_SARSEQ_SWITCH_ENABLE,
+        .sampleCtrl = (uint32_t)CY_SAR_RIGHT_ALIGN |
+                      (uint32_t)CY_SAR_SINGLE_ENDED_UNSIGNED |
+                      (uint32_t)CY_SAR_DIFFERENTIAL_SIGNED |
+                      (uint32_t)CY_SAR_AVG_CNT_2 |
+                      (uint32_t)CY_SAR_AVG_MODE_SEQUENTIAL_FIXED |
+                      (uint32_t)CY_SAR_TRIGGER_MODE_FW_AND_HWEDGE |
+                      SAR_SAMPLE_CTRL_EOS_DSI_OUT_EN_Msk,
+        .sampleTime01 = CURRENT_SENSE_SAMPLE_TIME,
+        .sampleTime23 = CURRENT_SENSE_SAMPLE_TIME,
+        .rangeThres = 0UL,
+        .rangeCond = CY_SAR_RANGE_COND_BELOW,
+        .chanEn = CURRENT_SENSE_CHAN_MASK,
+        .intrMask = 0UL,
+        .satIntrMask = 0UL,
+        .rangeIntrMask = 0UL,
+        .muxSwitch = (uint32_t)CY_SAR_MUX_FW_VSSA_VMINUS,
+        .muxSwitchSqCtrl = (uint32_t)CY_SAR_MUX_SQ_CTRL_VSSA,
+        .configRouting = true,
+        .vrefMvValue = CURRENT_SENSE_VREF_MV
+    };
+    cy_rslt_t result;
+    uint32_t channel;
+
+    /* Channel n samples SARMUX pin n against VSSA */
+    for (channel = 0U; channel < CURRENT_SENSE_CHANNELS; channel++)
+    {
+        sar_config.chanConfig[channel] =
+            (uint32_t)CY_SAR_CHAN_SINGLE_ENDED |
+            (uint32_t)CY_SAR_CHAN_SAMPLE_TIME_0 |
+            (uint32_t)CY_SAR_POS_PORT_ADDR_SARMUX |
+            _VAL2FLD(SAR_CHAN_CONFIG_POS_PIN_ADDR, channel) |
+            (uint32_t)CY_SAR_CHAN_AVG_DISABLE;
+        sar_config.muxSwitch |= (uint32_t)CY_SAR_MUX_FW_P0_VPLUS << channel;
+        sar_config.muxSwitchSqCtrl |= (uint32_t)CY_SAR_MUX_SQ_CTRL_P0 << channel;
+    }
+
+    /* SAR clock from a free peripheral divider, allocated through the HAL
+     * so that it cannot collide with the dividers the HAL drivers use */
+    result = cyhal_clock_allocate(&sar_clock,
+                                  CYHAL_CLOCK_BLOCK_PERIPHERAL_8BIT);
+    if (CY_RSLT_SUCCESS == result)
+    {
+        result = cyhal_clock_set_divider(&sar_clock,
+                                         CURRENT_SENSE_CLK_DIV_VALUE);
+    }
+    if (CY_RSLT_SUCCESS == result)
+    {
+        result = cyhal_clock_set_enabled(&sar_clock, true, false);
+    }
+    if (CY_RSLT_SUCCESS != result)
+    {
+        CY_ASSERT(0);
+    }
+    (void)Cy_SysClk_PeriphAssignDivider(PCLK_PASS_CLOCK_SAR,
+                                        CY_SYSCLK_DIV_8_BIT,
+                                        sar_clock.channel);
+
+    /* Analog reference block, needed by the SAR */
+    if (CY_SYSANALOG_SUCCESS != Cy_SysAnalog_Init(&Cy_SysAnalog_Fast_Local))
+    {
+        CY_ASSERT(0);
+    }
+    Cy_SysAnalog_Enable();
+
+    if (CY_SAR_SUCCESS != Cy_SAR_Init(CURRENT_SENSE_SAR, &sar_config))
+    {
+        CY_ASSERT(0);
+    }
+}
+
+/*******************************************************************************
+* Function Name: current_sense_descriptor_init
+********************************************************************************
+* Summary:
+* Sets up the 2D descriptor of one half. Each end-of-scan trigger runs one X
+* loop, which packs the 16-bit results of the channel result registers into
+* one set; the Y loop walks the sets of the half. Both descriptors chain to
+* each other, so the buffer is circular.
+*
+* Parameters:
+*  half - descriptor index, 0 or 1
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void current_sense_descriptor_init(uint32_t half)
+{
+    const cy_stc_dma_descriptor_config_t descriptor_config =
+    {
+        .retrigger       = CY_DMA_RETRIG_IM,
+        .interruptType   = CY_DMA_DESCR,
+        .triggerOutType  = CY_DMA_DESCR,
+        .channelState    = CY_DMA_CHANNEL_ENABLED,
+        .triggerInType   = CY_DMA_X_LOOP,
+        .dataSize        = CY_DMA_HALFWORD,
+        .srcTransferSize = CY_DMA_TRANSFER_SIZE_WORD,
+        .dstTransferSize = CY_DMA_TRANSFER_SIZE_DATA,
+        .descriptorType  = CY_DMA_2D_TRANSFER,
+        .srcAddress      = (void *)&CURRENT_SENSE_SAR->CHAN_RESULT[0],
+        .dstAddress      = (void *)&sample_ring[half *
+                                                CURRENT_SENSE_SETS_PER_HALF],
+        .srcXincrement   = 1,
+        .dstXincrement   = 1,
+        .xCount          = CURRENT_SENSE_CHANNELS,
+        .srcYincrement   = 0,
+        .dstYincrement   = (int32_t)CURRENT_SENSE_CHANNELS,
+        .yCount          = CURRENT_SENSE_SETS_PER_HALF,
+        .nextDescriptor  = &sample_descriptor[half ^ 1U]
+    };
+
+    if (CY_DMA_SUCCESS != Cy_DMA_Descriptor_Init(&sample_descriptor[half],
+                                                 &descriptor_config))
+    {
+        CY_ASSERT(0);
+    }
+}
+
+/*******************************************************************************
+* Function Name: current_sense_dma_isr
+********************************************************************************
+* Summary:
+* DataWire completion handler, runs once per filled half. The half that just
+* completed is the one the channel is not working on; if it is not the
+* expected one, a whole half was lost to interrupt latency.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void current_sense_dma_isr(void)
+{
+    uint32_t done_half;
+
+    Cy_DMA_Channel_ClearInterrupt(CURRENT_SENSE_DW, CURRENT_SENSE_DW_CHANNEL);
+
+    done_half = (Cy_DMA_Channel_GetCurrentDescriptor(CURRENT_SENSE_DW,
+                                                     CURRENT_SENSE_DW_CHANNEL)
+                 == &sample_descriptor[1]) ? 0U : 1U;
+    if (done_half != expected_half)
+    {
+        overrun_count++;
+    }
+    expected_half = done_half ^ 1U;
+
+    if (NULL != sample_callback)
+    {
+        sample_callback(&sample_ring[done_half * CURRENT_SENSE_SETS_PER_HALF],
+                        CURRENT_SENSE_SETS_PER_HALF, sample_callback_arg);
+    }
+}
+
+#endif /* CURRENT_SENSE_ENABLE */
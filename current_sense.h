@@ -0,0 +1,99 @@
+/*******************************************************************************
+* File Name:   current_sense.h
+*
+* Description: Zero-CPU current sampling synchronized to the PWM. The
+* overflow trigger output (tr_out1) of the counter starts a SAR ADC scan at
+* the peak of every PWM period, and the end-of-scan trigger of the SAR starts
+* a DataWire channel that copies the channel results into a circular buffer.
+* The buffer is split into two halves; the application is called back only
+* when a half holds complete sample sets.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2020-2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef CURRENT_SENSE_H_
+#define CURRENT_SENSE_H_
+
+#include "cy_pdl.h"
+#include "app_config.h"
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+/* One sample set: a result per SAR channel, taken within the same scan */
+typedef struct
+{
+    uint16_t sample[CURRENT_SENSE_CHANNELS];
+} current_sense_set_t;
+
+/* Called from the DMA interrupt with the sets of the half that completed.
+ * The sets are overwritten again one half later. */
+typedef void (*current_sense_callback_t)(const current_sense_set_t *sets,
+                                         uint32_t count, void *callback_arg);
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+void current_sense_init(void);
+void current_sense_register_callback(current_sense_callback_t callback,
+                                     void *callback_arg);
+void current_sense_start(void);
+void current_sense_stop(void);
+uint32_t current_sense_get_overrun_count(void);
+
+/*******************************************************************************
+* Function Name: current_sense_read
+********************************************************************************
+* Summary:
+* Returns the result of a channel from the newest scan, read directly from
+* the SAR result register. The scan started at the peak of the period has
+* finished by the next terminal count, so a terminal count handler gets the
+* sample of the period that just ended without waiting for the DMA.
+*
+* Parameters:
+*  channel - SAR channel, less than CURRENT_SENSE_CHANNELS
+*
+* Return:
+*  uint32_t - raw SAR result
+*
+*******************************************************************************/
+__STATIC_INLINE uint32_t current_sense_read(uint32_t channel)
+{
+    CY_ASSERT(channel < CURRENT_SENSE_CHANNELS);
+
+    return CURRENT_SENSE_SAR->CHAN_RESULT[channel] & 0xFFFFUL;
+}
+
+#endif /* CURRENT_SENSE_H_ */
@@ -0,0 +1,392 @@
+/*******************************************************************************
+* File Name:   latency_trace.c
+*
+* Description: Cycle-accurate latency instrumentation. Timestamps each
+* stage of the command path with the DWT cycle counter, from the UART RX
+* interrupt to the compare swap trigger, and keeps min/max/histogram
+* statistics per stage. All hooks compile to nothing unless
+* LATENCY_TRACE_ENABLE is set.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2020-2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include "cy_pdl.h"
+#include "app_log.h"
+#include "latency_trace.h"
+
+#if (LATENCY_TRACE_ENABLE)
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+/* Longest lines of the dump, rounded up: the stage line with three 10 digit
+ * values and a bucket line such as "\t>=16384\t4294967295\r\n" */
+#define LATENCY_TRACE_STAGE_LINE_SIZE   (64U)
+#define LATENCY_TRACE_BUCKET_LINE_SIZE  (32U)
+
+/* latency_trace_dump() queues one stage, its line and all buckets, at a time */
+#if ((LATENCY_TRACE_STAGE_LINE_SIZE + (LATENCY_TRACE_BUCKETS * \
+      LATENCY_TRACE_BUCKET_LINE_SIZE)) > APP_LOG_BUFFER_SIZE)
+#error "APP_LOG_BUFFER_SIZE too small for one stage of the latency dump"
+#endif
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+static void latency_trace_record(latency_stage_t stage, uint32_t origin);
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+static latency_stats_t stage_stats[LATENCY_STAGE_COUNT];
+
+/* Timestamp of the first byte received since the last batch (RX ISR) */
+static volatile uint32_t rx_origin;
+static volatile bool rx_armed = false;
+
+/* Origin of the batch being processed by the main loop */
+static uint32_t batch_origin;
+
+/* Origin handed over to the commit ISR together with the staged values */
+static volatile uint32_t commit_origin;
+static volatile bool commit_armed = false;
+
+static const char *const stage_names[LATENCY_STAGE_COUNT] =
+{
+    "dequeue",
+    "compute",
+    "buffer_write",
+    "swap_trigger"
+};
+
+/*******************************************************************************
+* Function Name: latency_trace_init
+********************************************************************************
+* Summary:
+* Enables the DWT cycle counter and clears the statistics.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void latency_trace_init(void)
+{
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0U;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    latency_trace_reset();
+}
+
+/*******************************************************************************
+* Function Name: latency_trace_rx
+********************************************************************************
+* Summary:
+* Called from the UART RX interrupt. Takes the origin timestamp for the next
+* batch if none is taken yet.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void latency_trace_rx(void)
+{
+    if (!rx_armed)
+    {
+        rx_origin = DWT->CYCCNT;
+        rx_armed = true;
+    }
+}
+
+/*******************************************************************************
+* Function Name: latency_trace_begin
+********************************************************************************
+* Summary:
+* Called by the main loop before it drains the RX queue. Takes over the RX
+* origin for this batch and records the dequeue stage.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void latency_trace_begin(void)
+{
+    uint32_t saved_intr = Cy_SysLib_EnterCriticalSection();
+    bool armed = rx_armed;
+
+    batch_origin = rx_origin;
+    rx_armed = false;
+    Cy_SysLib_ExitCriticalSection(saved_intr);
+
+    if (armed)
+    {
+        latency_trace_record(LATENCY_STAGE_DEQUEUE, batch_origin);
+    }
+}
+
+/*******************************************************************************
+* Function Name: latency_trace_mark
+********************************************************************************
+* Summary:
+* Records a main loop stage of the current batch.
+*
+* Parameters:
+*  stage - stage that was just completed
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void latency_trace_mark(latency_stage_t stage)
+{
+    latency_trace_record(stage, batch_origin);
+}
+
+/*******************************************************************************
+* Function Name: latency_trace_publish
+********************************************************************************
+* Summary:
+* Hands the origin of the current batch to the commit ISR. Called right
+* before the new compare values are staged.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void latency_trace_publish(void)
+{
+    commit_origin = batch_origin;
+    commit_armed = true;
+}
+
+/*******************************************************************************
+* Function Name: latency_trace_commit_mark
+********************************************************************************
+* Summary:
+* Records a stage of the commit ISR for the last published batch.
+*
+* Parameters:
+*  stage - stage that was just completed
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void latency_trace_commit_mark(latency_stage_t stage)
+{
+    if (commit_armed)
+    {
+        latency_trace_record(stage, commit_origin);
+    }
+}
+
+/*******************************************************************************
+* Function Name: latency_trace_commit_end
+********************************************************************************
+* Summary:
+* Closes the trace of the last published batch.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void latency_trace_commit_end(void)
+{
+    commit_armed = false;
+}
+
+/*******************************************************************************
+* Function Name: latency_trace_get_stats
+********************************************************************************
+* Summary:
+* Copies the statistics of one stage.
+*
+* Parameters:
+*  stage - stage to read
+*  stats - destination
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void latency_trace_get_stats(latency_stage_t stage, latency_stats_t *stats)
+{
+    uint32_t saved_intr = Cy_SysLib_EnterCriticalSection();
+
+    *stats = stage_stats[stage];
+    Cy_SysLib_ExitCriticalSection(saved_intr);
+}
+
+/*******************************************************************************
+* Function Name: latency_trace_reset
+********************************************************************************
+* Summary:
+* Clears the statistics of all stages.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void latency_trace_reset(void)
+{
+    uint32_t saved_intr = Cy_SysLib_EnterCriticalSection();
+    uint32_t stage;
+    uint32_t bucket;
+
+    for (stage = 0U; stage < (uint32_t)LATENCY_STAGE_COUNT; stage++)
+    {
+        stage_stats[stage].count = 0U;
+        stage_stats[stage].min = UINT32_MAX;
+        stage_stats[stage].max = 0U;
+        for (bucket = 0U; bucket < LATENCY_TRACE_BUCKETS; bucket++)
+        {
+            stage_stats[stage].histogram[bucket] = 0U;
+        }
+    }
+    Cy_SysLib_ExitCriticalSection(saved_intr);
+}
+
+/*******************************************************************************
+* Function Name: latency_trace_dump
+********************************************************************************
+* Summary:
+* Queues the statistics of all stages to the deferred log, one line per
+* stage: name, count, min, max and the histogram buckets in cycles. Waits
+* for the log to drain before each stage, so the dump is never truncated by
+* the size of the log queue. Must be called from the main loop.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void latency_trace_dump(void)
+{
+    latency_stats_t stats;
+    uint32_t stage;
+    uint32_t bucket;
+
+    app_log_printf("Latency [cycles @ %lu Hz]\r\n",
+                   (unsigned long)SystemCoreClock);
+
+    for (stage = 0U; stage < (uint32_t)LATENCY_STAGE_COUNT; stage++)
+    {
+        app_log_flush();
+        latency_trace_get_stats((latency_stage_t)stage, &stats);
+        app_log_printf("%s\tn=%lu\tmin=%lu\tmax=%lu\r\n", stage_names[stage],
+                       (unsigned long)stats.count,
+                       (unsigned long)((0U == stats.count) ? 0U : stats.min),
+                       (unsigned long)stats.max);
+        for (bucket = 0U; bucket < LATENCY_TRACE_BUCKETS; bucket++)
+        {
+            if (0U == stats.histogram[bucket])
+            {
+                continue;
+            }
+            if (bucket == (LATENCY_TRACE_BUCKETS - 1U))
+            {
+                app_log_printf("\t>=%lu\t%lu\r\n",
+                               (unsigned long)(1UL << (bucket - 1U)),
+                               (unsigned long)stats.histogram[bucket]);
+            }
+            else
+            {
+                app_log_printf("\t<%lu\t%lu\r\n", (unsigned long)(1UL << bucket),
+                               (unsigned long)stats.histogram[bucket]);
+            }
+        }
+    }
+}
+
+/*******************************************************************************
+* Function Name: latency_trace_record
+********************************************************************************
+* Summary:
+* Adds one sample to the statistics of a stage.
+*
+* Parameters:
+*  stage - stage to update
+*  origin - cycle counter value at the RX interrupt
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void latency_trace_record(latency_stage_t stage, uint32_t origin)
+{
+    uint32_t saved_intr = Cy_SysLib_EnterCriticalSection();
+    uint32_t cycles = DWT->CYCCNT - origin;
+    uint32_t bucket = 32U - __CLZ(cycles);
+    latency_stats_t *stats = &stage_stats[stage];
+
+    if (bucket >= LATENCY_TRACE_BUCKETS)
+    {
+        bucket = LATENCY_TRACE_BUCKETS - 1U;
+    }
+
+    stats->count++;
+    stats->histogram[bucket]++;
+    if (cycles < stats->min)
+    {
+        stats->min = cycles;
+    }
+    if (cycles > stats->max)
+    {
+        stats->max = cycles;
+    }
+    Cy_SysLib_ExitCriticalSection(saved_intr);
+}
+
+#endif /* LATENCY_TRACE_ENABLE */
@@ -0,0 +1,109 @@
+/*******************************************************************************
+* File Name:   latency_trace.h
+*
+* Description: Cycle-accurate latency instrumentation. Timestamps each
+* stage of the command path with the DWT cycle counter, from the UART RX
+* interrupt to the compare swap trigger, and keeps min/max/histogram
+* statistics per stage. All hooks compile to nothing unless
+* LATENCY_TRACE_ENABLE is set.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2020-2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef LATENCY_TRACE_H_
+#define LATENCY_TRACE_H_
+
+#include "cy_pdl.h"
+#include "app_config.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define LATENCY_TRACE_BUCKETS   (16U) /* Bucket n holds [2^(n-1), 2^n) cycles */
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+/* Stages measured relative to the RX interrupt of the first byte of a batch */
+typedef enum
+{
+    LATENCY_STAGE_DEQUEUE,      /* Main loop picked up the batch */
+    LATENCY_STAGE_COMPUTE,      /* New compare values computed and clamped */
+    LATENCY_STAGE_BUFFER_WRITE, /* CC0/CC1 buffer registers written */
+    LATENCY_STAGE_SWAP_TRIGGER, /* Compare swap triggered */
+    LATENCY_STAGE_COUNT
+} latency_stage_t;
+
+typedef struct
+{
+    uint32_t count;                              /* Number of samples */
+    uint32_t min;                                /* Shortest, in cycles */
+    uint32_t max;                                /* Longest, in cycles */
+    uint32_t histogram[LATENCY_TRACE_BUCKETS];   /* Log2 distribution */
+} latency_stats_t;
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+#if (LATENCY_TRACE_ENABLE)
+void latency_trace_init(void);
+void latency_trace_rx(void);
+void latency_trace_begin(void);
+void latency_trace_mark(latency_stage_t stage);
+void latency_trace_publish(void);
+void latency_trace_commit_mark(latency_stage_t stage);
+void latency_trace_commit_end(void);
+void latency_trace_get_stats(latency_stage_t stage, latency_stats_t *stats);
+void latency_trace_reset(void);
+void latency_trace_dump(void);
+
+#define LATENCY_TRACE_INIT()            latency_trace_init()
+#define LATENCY_TRACE_RX()              latency_trace_rx()
+#define LATENCY_TRACE_BEGIN()           latency_trace_begin()
+#define LATENCY_TRACE_MARK(stage)       latency_trace_mark(stage)
+#define LATENCY_TRACE_PUBLISH()         latency_trace_publish()
+#define LATENCY_TRACE_COMMIT_MARK(stage) latency_trace_commit_mark(stage)
+#define LATENCY_TRACE_COMMIT_END()      latency_trace_commit_end()
+#else
+#define LATENCY_TRACE_INIT()
+#define LATENCY_TRACE_RX()
+#define LATENCY_TRACE_BEGIN()
+#define LATENCY_TRACE_MARK(stage)
+#define LATENCY_TRACE_PUBLISH()
+#define LATENCY_TRACE_COMMIT_MARK(stage)
+#define LATENCY_TRACE_COMMIT_END()
+#endif /* LATENCY_TRACE_ENABLE */
+
+#endif /* LATENCY_TRACE_H_ */
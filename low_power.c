@@ -0,0 +1,214 @@
+/*******************************************************************************
+* File Name:   low_power.c
+*
+* Description: Idle handling of the main loop. The CPU enters Sleep between
+* events, which gates only the CPU clock, so the counter keeps generating the
+* PWM and the UART keeps receiving. DeepSleep stops clk_peri and with it the
+* counter and the UART, so a SysPm callback refuses it while the PWM runs.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2020-2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include "cy_pdl.h"
+#include "cybsp.h"
+#include "app_config.h"
+#include "low_power.h"
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+static cy_en_syspm_status_t low_power_deepsleep_callback(
+                                    cy_stc_syspm_callback_params_t *params,
+                                    cy_en_syspm_callback_mode_t mode);
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+static TCPWM_Type *pwm_base; /* Counter that must not be stopped */
+static uint32_t pwm_cnt_num;
+static volatile uint32_t sleep_count = 0U;
+static volatile uint32_t deepsleep_count = 0U;
+
+static cy_stc_syspm_callback_params_t deepsleep_params =
+{
+    .base = NULL,
+    .context = NULL
+};
+
+/* Lowest order, so it is checked before the callbacks of the HAL drivers */
+static cy_stc_syspm_callback_t deepsleep_callback =
+{
+    .callback = low_power_deepsleep_callback,
+    .type = CY_SYSPM_DEEPSLEEP,
+    .skipMode = 0U,
+    .callbackParams = &deepsleep_params,
+    .prevItm = NULL,
+    .nextItm = NULL,
+    .order = LOW_POWER_CALLBACK_ORDER
+};
+
+/*******************************************************************************
+* Function Name: low_power_init
+********************************************************************************
+* Summary:
+* Registers the DeepSleep callback that protects the given counter. Call it
+* after the HAL drivers are initialized.
+*
+* Parameters:
+*  base - TCPWM block base address
+*  cnt_num - counter number within the block
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void low_power_init(TCPWM_Type *base, uint32_t cnt_num)
+{
+    pwm_base = base;
+    pwm_cnt_num = cnt_num;
+    deepsleep_params.base = base;
+
+    if (!Cy_SysPm_RegisterCallback(&deepsleep_callback))
+    {
+        CY_ASSERT(0);
+    }
+}
+
+/*******************************************************************************
+* Function Name: low_power_idle
+********************************************************************************
+* Summary:
+* Puts the CPU to sleep until the next interrupt. With
+* LOW_POWER_DEEPSLEEP_ENABLE, DeepSleep is tried first; the SysPm callbacks
+* of this module and of the HAL drivers reject it while the PWM runs or a
+* UART transfer is in progress, and the CPU then enters Sleep instead. Must
+* be called with interrupts masked; a pending interrupt still wakes the CPU.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void low_power_idle(void)
+{
+#if (LOW_POWER_DEEPSLEEP_ENABLE)
+    if (CY_SYSPM_SUCCESS ==
+        Cy_SysPm_CpuEnterDeepSleep(CY_SYSPM_WAIT_FOR_INTERRUPT))
+    {
+        deepsleep_count++;
+        return;
+    }
+#endif
+
+    if (CY_SYSPM_SUCCESS == Cy_SysPm_CpuEnterSleep(CY_SYSPM_WAIT_FOR_INTERRUPT))
+    {
+        sleep_count++;
+    }
+}
+
+/*******************************************************************************
+* Function Name: low_power_get_sleep_count
+********************************************************************************
+* Summary:
+* Returns how many times the CPU entered Sleep.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  uint32_t - number of Sleep entries since startup
+*
+*******************************************************************************/
+uint32_t low_power_get_sleep_count(void)
+{
+    return sleep_count;
+}
+
+/*******************************************************************************
+* Function Name: low_power_get_deepsleep_count
+********************************************************************************
+* Summary:
+* Returns how many times the CPU entered DeepSleep.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  uint32_t - number of DeepSleep entries since startup
+*
+*******************************************************************************/
+uint32_t low_power_get_deepsleep_count(void)
+{
+    return deepsleep_count;
+}
+
+/*******************************************************************************
+* Function Name: low_power_deepsleep_callback
+********************************************************************************
+* Summary:
+* SysPm DeepSleep callback. DeepSleep stops clk_peri, which would freeze the
+* counter with its output at whatever level it had, so the transition is
+* refused while the counter runs. A stopped counter keeps its configuration
+* in DeepSleep and needs no handling on wakeup.
+*
+* Parameters:
+*  params - callback parameters, base is the TCPWM block
+*  mode - SysPm callback mode
+*
+* Return:
+*  cy_en_syspm_status_t - CY_SYSPM_FAIL to reject the transition
+*
+*******************************************************************************/
+static cy_en_syspm_status_t low_power_deepsleep_callback(
+                                    cy_stc_syspm_callback_params_t *params,
+                                    cy_en_syspm_callback_mode_t mode)
+{
+    cy_en_syspm_status_t status = CY_SYSPM_SUCCESS;
+
+    (void)params;
+
+    if (CY_SYSPM_CHECK_READY == mode)
+    {
+        if (0U != (Cy_TCPWM_PWM_GetStatus(pwm_base, pwm_cnt_num) &
+                   CY_TCPWM_PWM_STATUS_COUNTER_RUNNING))
+        {
+            status = CY_SYSPM_FAIL;
+        }
+    }
+
+    return status;
+}
@@ -49,28 +49,102 @@
 #include "cyhal.h"
 #include "cybsp.h"
 #include "cy_retarget_io.h"
+#include "app_config.h"
+#include "ring_buffer.h"
+#include "pwm_update.h"
+#include "pwm_stream.h"
+#include "app_log.h"
+#include "cmd_protocol.h"
+#include "latency_trace.h"
+#include "bench.h"
+#include "pwm_math.h"
+#include "pwm_keys.h"
+#include "current_sense.h"
+#include "low_power.h"
+#include "pwm_capture.h"
+#include "pwm_fault.h"
+#include "setpoint_ipc.h"
+#include "pwm_sync.h"
+#include "pwm_clock.h"
+#include "telemetry.h"
+#include "pwm_regulator.h"
 
 /*******************************************************************************
 * Macros
 *******************************************************************************/
 #define UART_IRQ_PRIORITY       (3)
-#define COMPARE_VALUE_DELTA     (100)
-#define DELAY_BETWEEN_READ_MS   (100)
+#define COMPARE_VALUE_DELTA     (100) /* At PWM_CLOCK_REFERENCE_HZ */
+#define UART_RX_BUFFER_SIZE     (256) /* Must be a power of two */
 
 /*******************************************************************************
 * Function Prototypes
 *******************************************************************************/
 void uart_event_handler(void *handler_arg, cyhal_uart_event_t event);
+void print_banner(void);
 void print_instructions(void);
 void process_key_press(char);
+void process_frame(const cmd_protocol_command_t *command);
+int32_t clamp_compare(int32_t value, bool *clamped);
+void commit_compare_values(void);
+void print_update_counters(void);
+cmd_protocol_status_t change_period(int32_t new_period);
+#if (PWM_UPDATE_DEAD_TIME_ENABLE)
+cmd_protocol_status_t change_output(int32_t dead_time, int32_t complementary);
+#endif
+#if (PWM_UPDATE_SEQUENCER_ENABLE)
+cmd_protocol_status_t store_sequence_step(const cmd_protocol_command_t *command);
+cmd_protocol_status_t run_sequence(int32_t count, int32_t repeat);
+bool check_sequence(uint32_t count, bool repeated);
+void report_sequence_done(void);
+#endif
+#if (PWM_REGULATOR_ENABLE)
+cmd_protocol_status_t run_regulator(int32_t setpoint, int32_t run);
+void print_regulator(void);
+#endif
+#if (CURRENT_SENSE_ENABLE)
+void current_sense_handler(const current_sense_set_t *sets, uint32_t count,
+                           void *callback_arg);
+void print_currents(void);
+#endif
+#if (PWM_FAULT_ENABLE)
+void report_fault(void);
+#endif
+#if (PWM_CAPTURE_ENABLE)
+void pwm_capture_handler(const pwm_capture_sample_t *samples, uint32_t count,
+                         void *callback_arg);
+void print_capture(void);
+#endif
 
 /*******************************************************************************
 * Global Variables
 *******************************************************************************/
+/* Working copies of the waveform, owned by the main loop. Interrupts never
+ * access them; they only see the values published through pwm_update. */
 uint32_t period; /* Variable to store period value of TCPWM block */
 int32_t compare0_value; /* Variable to store the CC0 value of TCPWM block */
 int32_t compare1_value; /* Variable to store the CC1 value of TCPWM block */
-volatile bool uart_read_flag = false;
+int32_t compare_delta; /* Key step, COMPARE_VALUE_DELTA at the counter clock */
+uint8_t uart_rx_storage[UART_RX_BUFFER_SIZE]; /* Backing memory of RX queue */
+ring_buffer_t uart_rx_queue; /* Bytes received by the UART ISR */
+bool compare_dirty = false; /* Compare values changed since last commit */
+bool banner_pending = true; /* Title and instructions not printed yet */
+#if (PWM_UPDATE_SEQUENCER_ENABLE)
+/* Step table played by the terminal count ISR, filled through opcode 0x06 */
+pwm_update_step_t sequence_table[PWM_UPDATE_SEQUENCE_MAX_STEPS];
+#endif
+#if (CURRENT_SENSE_ENABLE)
+volatile current_sense_set_t latest_currents; /* Newest current sample set */
+#endif
+#if (PWM_CAPTURE_ENABLE)
+volatile pwm_capture_sample_t latest_capture; /* Newest captured input cycle */
+#endif
+
+/* Startup title. \x1b[2J\x1b[;H - ANSI ESC sequence for clear screen */
+static const char banner[] =
+       "\x1b[2J\x1b[;H"
+       "***********************************************************\r\n"
+       "PSoC 6 MCU: TCPWM in PWM Mode with Dual Compare/Capture\r\n"
+       "***********************************************************\r\n\n";
 
 /*******************************************************************************
 * Function Name: main
@@ -78,9 +152,10 @@ volatile bool uart_read_flag = false;
 * Summary:
 * This is the main function for CM4 CPU. Initializes the retarget-IO and sets
 * up a callback to be triggered upon receiving data. It sets up the TCPWM in
-* PWM mode. The infinite loop sets up asynchronous UART read and depending on
-* the command read, the compare values are modified to change the duty cycle and
-* phase.
+* PWM mode. The infinite loop drains the bytes queued by the UART interrupt
+* through the binary frame parser and depending on the key or frame read, the
+* compare values are modified to change the duty cycle and phase. The CPU
+* sleeps until the next interrupt when there is no pending command.
 *
 * Parameters:
 *  void
@@ -92,7 +167,14 @@ volatile bool uart_read_flag = false;
 int main(void)
 {
     cy_rslt_t result;
-    char uart_read_value; /* Variable to store the read command through UART */
+#if !(SETPOINT_IPC_ENABLE)
+    uint8_t uart_read_value; /* Variable to store the read command through UART */
+    uint32_t batch_length; /* Number of queued bytes handled as one batch */
+    cmd_protocol_command_t command; /* Command decoded from a binary frame */
+#endif
+#if (PWM_UPDATE_DEAD_TIME_ENABLE)
+    cy_stc_tcpwm_pwm_config_t pwm_config; /* Design file config, dead time */
+#endif
 
     /* Initialize the device and board peripherals */
     result = cybsp_init() ;
@@ -101,24 +183,58 @@ int main(void)
         CY_ASSERT(0);
     }
 
+    /* Start the cycle counter used by the latency instrumentation */
+    LATENCY_TRACE_INIT();
+
+    /* Initialize the queue filled by the UART interrupt. It stays empty in
+     * the split-core configuration, so the main loop only sleeps. */
+    ring_buffer_init(&uart_rx_queue, uart_rx_storage, sizeof(uart_rx_storage));
+
+#if !(SETPOINT_IPC_ENABLE)
     /* Initialize retarget-io to use the debug UART port */
     cy_retarget_io_init(CYBSP_DEBUG_UART_TX, CYBSP_DEBUG_UART_RX,
                         CY_RETARGET_IO_BAUDRATE);
 
+    /* Initialize the deferred log sent in the background */
+    app_log_init(&cy_retarget_io_uart_obj);
+
     /* The UART callback handler registration */
     cyhal_uart_register_callback(&cy_retarget_io_uart_obj, uart_event_handler,
                                  NULL);
 
-    /* Enable UART events to get notified on receiving
-     * RX data and on RX errors */
+    /* Enable UART events to get notified on every received byte, on
+     * completion of log transfers and on RX errors */
     cyhal_uart_enable_event(&cy_retarget_io_uart_obj,
                             (cyhal_uart_event_t)(CYHAL_UART_IRQ_RX_ERROR |
-                            CYHAL_UART_IRQ_RX_DONE),
+                            CYHAL_UART_IRQ_RX_NOT_EMPTY |
+                            CYHAL_UART_IRQ_TX_DONE),
                             UART_IRQ_PRIORITY, true);
+#endif
 
     /* Initialize and enable the TCPWM block */
+#if (PWM_UPDATE_DEAD_TIME_ENABLE)
+    /* On TCPWM v2 the dead time field of the plain PWM mode is the clock
+     * prescaler, so the counter must run in dead time mode to insert it */
+    pwm_config = TCPWM0_GRP1_CNT0_config;
+    pwm_config.pwmMode = CY_TCPWM_PWM_MODE_DEADTIME;
+    pwm_config.deadTimeClocks = 0U;
+    Cy_TCPWM_PWM_Init(TCPWM0_GRP1_CNT0_HW, TCPWM0_GRP1_CNT0_NUM, &pwm_config);
+#else
     Cy_TCPWM_PWM_Init(TCPWM0_GRP1_CNT0_HW, TCPWM0_GRP1_CNT0_NUM,
                       &TCPWM0_GRP1_CNT0_config);
+#endif
+
+    /* P5.1 is routed to line_compl in every build. Hold it low until the
+     * complementary output is enabled through opcode 0x04, so a low-side
+     * gate on the pin is never switched by the inverted PWM. */
+    (void)Cy_TCPWM_PWM_Configure_LineSelect(TCPWM0_GRP1_CNT0_HW,
+                                            TCPWM0_GRP1_CNT0_NUM,
+                                            CY_TCPWM_OUTPUT_PWM_SIGNAL,
+                                            CY_TCPWM_OUTPUT_CONSTANT_0);
+
+    /* Select the counter clock and scale the design file values to it */
+    pwm_clock_init(TCPWM0_GRP1_CNT0_HW, TCPWM0_GRP1_CNT0_NUM);
+    compare_delta = (int32_t)pwm_clock_ticks(COMPARE_VALUE_DELTA);
     Cy_TCPWM_PWM_Enable(TCPWM0_GRP1_CNT0_HW, TCPWM0_GRP1_CNT0_NUM);
 
     /* Fetch the initial values of period, CC0 and CC1 registers configured
@@ -129,42 +245,140 @@ int main(void)
     compare0_value = Cy_TCPWM_PWM_GetCompare0Val(TCPWM0_GRP1_CNT0_HW,
                                                  TCPWM0_GRP1_CNT0_NUM);
 
-    /* Start the TCPWM block */
-    Cy_TCPWM_TriggerStart_Single(TCPWM0_GRP1_CNT0_HW, TCPWM0_GRP1_CNT0_NUM);
+    /* Commit compare updates from the terminal count interrupt */
+    pwm_update_init(TCPWM0_GRP1_CNT0_HW, TCPWM0_GRP1_CNT0_NUM,
+                    TCPWM0_GRP1_CNT0_IRQ);
+
+#if (SETPOINT_IPC_ENABLE)
+    /* Split-core configuration: the CM0+ owns the UART and sends validated
+     * setpoints, which the IPC interrupt stages. This core runs the common
+     * start-up and the main loop without the serial part, so no serial I/O
+     * or formatting can delay the terminal count ISR. */
+    setpoint_ipc_init();
+#endif
+
+#if (PWM_STREAM_ENABLE)
+    /* Route the terminal count to the DataWire channel for table streaming */
+    pwm_stream_init(TCPWM0_GRP1_CNT0_HW, TCPWM0_GRP1_CNT0_NUM);
+#endif
+
+#if (CURRENT_SENSE_ENABLE)
+    /* Sample the phase currents on every overflow of the counter */
+    current_sense_init();
+    current_sense_register_callback(current_sense_handler, NULL);
+    current_sense_start();
+#endif
+
+#if (PWM_CAPTURE_ENABLE)
+    /* Measure the input signal (the PWM output in the loop-back test) */
+    pwm_capture_init();
+    pwm_capture_register_callback(pwm_capture_handler, NULL);
+    pwm_capture_start();
+#endif
+
+#if (PWM_FAULT_ENABLE)
+    /* Stop the counter in hardware on the fault pin */
+    pwm_fault_init(TCPWM0_GRP1_CNT0_HW, TCPWM0_GRP1_CNT0_NUM);
+#endif
+
+    /* Keep DeepSleep away while the counter generates the PWM */
+    low_power_init(TCPWM0_GRP1_CNT0_HW, TCPWM0_GRP1_CNT0_NUM);
+
+#if (PWM_SYNC_ENABLE)
+    /* The first edge of the sync input starts the TCPWM block */
+    pwm_sync_init(TCPWM0_GRP1_CNT0_HW, TCPWM0_GRP1_CNT0_NUM);
+#else
+    /* Start the TCPWM block, unless the fault signal is already active */
+#if (PWM_FAULT_ENABLE)
+    if (!pwm_fault_is_latched())
+#endif
+    {
+        Cy_TCPWM_TriggerStart_Single(TCPWM0_GRP1_CNT0_HW, TCPWM0_GRP1_CNT0_NUM);
+    }
+#endif
 
     /* Enable global interrupts */
     __enable_irq();
 
-    /* \x1b[2J\x1b[;H - ANSI ESC sequence for clear screen */
-    printf("\x1b[2J\x1b[;H");
+#if !(SETPOINT_IPC_ENABLE)
+#if (BENCH_ENABLE)
+    /* Run the benchmark suite before the interactive example */
+    bench_run(TCPWM0_GRP1_CNT0_HW, TCPWM0_GRP1_CNT0_NUM);
+#endif
 
-    printf("***********************************************************\r\n"
-           "PSoC 6 MCU: TCPWM in PWM Mode with Dual Compare/Capture\r\n"
-           "***********************************************************\r\n\n");
-
-    print_instructions();
+#if !(APP_QUICK_START_ENABLE)
+    /* Clear the screen and print the title */
+    print_banner();
+#endif
+#endif
 
     for (;;)
     {
-        /* Begin asynchronous RX read */
-        cyhal_uart_read_async(&cy_retarget_io_uart_obj,
-                              (void*) &uart_read_value,
-                              sizeof(uart_read_value));
-
-        /* Check if the read flag has been set by the callback */
-        if(uart_read_flag)
+#if !(SETPOINT_IPC_ENABLE)
+        /* Process every queued command and modify the compare values to
+         * change the duty cycle and phase. Bytes outside of a binary frame
+         * are single-key commands. The batch is limited to the bytes queued
+         * at this point so that a continuous stream cannot delay the commit.
+         */
+        batch_length = ring_buffer_count(&uart_rx_queue);
+        if (0U != batch_length)
         {
-            /* Clear read flag */
-            uart_read_flag = false;
+            LATENCY_TRACE_BEGIN();
+        }
+        while ((batch_length-- > 0U) &&
+               ring_buffer_pop(&uart_rx_queue, &uart_read_value))
+        {
+            switch (cmd_protocol_feed(uart_read_value, &command))
+            {
+                case CMD_PROTOCOL_KEY:
+#if (APP_QUICK_START_ENABLE)
+                    /* The first key press brings up the terminal */
+                    print_banner();
+#endif
+                    process_key_press((char)uart_read_value);
+                    break;
+                case CMD_PROTOCOL_FRAME:
+                case CMD_PROTOCOL_ERROR:
+                    process_frame(&command);
+                    break;
+                default:
+                    break;
+            }
+        }
 
-            /* Process the command and modify the compare values to change the
-             * duty cycle and phase.
-             */
-            process_key_press(uart_read_value);
+        /* Commit the net result of the batch with a single compare swap */
+        if (compare_dirty)
+        {
+            commit_compare_values();
         }
 
-        /* Delay between next read */
-        cyhal_system_delay_ms(DELAY_BETWEEN_READ_MS);
+#if (PWM_FAULT_ENABLE)
+        /* The counter was already stopped in hardware, only report it */
+        report_fault();
+#endif
+
+#if (PWM_UPDATE_SEQUENCER_ENABLE)
+        /* The sequence ran in the ISR, only report its end */
+        report_sequence_done();
+#endif
+
+#if (TELEMETRY_ENABLE)
+        /* Send the waveform sampled by the ISR, if any */
+        telemetry_poll();
+#endif
+#endif /* !SETPOINT_IPC_ENABLE */
+
+        /* Sleep until the next interrupt. The counter and the UART stay
+         * clocked in Sleep. The queue is checked again with interrupts
+         * masked so that a byte received after the loop above cannot be
+         * missed; a pending interrupt still wakes the CPU from WFI.
+         */
+        __disable_irq();
+        if (ring_buffer_is_empty(&uart_rx_queue))
+        {
+            low_power_idle();
+        }
+        __enable_irq();
     }
 }
 
@@ -172,8 +386,9 @@ int main(void)
 * Function Name: uart_event_handler
 ********************************************************************************
 * Summary:
-* UART event handler callback function. Sets the read flag to true upon
-* successful reception of data.
+* UART event handler callback function. Moves every byte available in the RX
+* FIFO into the RX queue so that bursts are not lost while the main loop is
+* busy, and hands completed TX transfers to the deferred log.
 *
 * Parameters:
 *  handler_arg - argument for the handler provided during callback registration
@@ -187,12 +402,31 @@ void uart_event_handler(void *handler_arg, cyhal_uart_event_t event)
 {
     (void)handler_arg;
 
-    if (CYHAL_UART_IRQ_RX_DONE == (event & CYHAL_UART_IRQ_RX_DONE))
+    uint8_t rx_byte;
+
+    if (CYHAL_UART_IRQ_RX_NOT_EMPTY == (event & CYHAL_UART_IRQ_RX_NOT_EMPTY))
     {
-        /* Set read flag */
-        uart_read_flag = true;
+        LATENCY_TRACE_RX();
+
+        /* Drain the hardware FIFO into the RX queue */
+        while (cyhal_uart_readable(&cy_retarget_io_uart_obj) > 0U)
+        {
+            if (CY_RSLT_SUCCESS != cyhal_uart_getc(&cy_retarget_io_uart_obj,
+                                                   &rx_byte, 0U))
+            {
+                break;
+            }
+            (void)ring_buffer_push(&uart_rx_queue, rx_byte);
+        }
     }
-    else
+
+    if (CYHAL_UART_IRQ_TX_DONE == (event & CYHAL_UART_IRQ_TX_DONE))
+    {
+        /* Continue with the next queued log bytes */
+        app_log_tx_done();
+    }
+
+    if (CYHAL_UART_IRQ_RX_ERROR == (event & CYHAL_UART_IRQ_RX_ERROR))
     {
         CY_ASSERT(0);
     }
@@ -203,8 +437,9 @@ void uart_event_handler(void *handler_arg, cyhal_uart_event_t event)
 ********************************************************************************
 * Summary:
 * Function to process the key pressed. Depending on the command passed as
-* parameter, new compare values are calculated. The values are written to
-* the respective buffer registers and a compare swap is issued.
+* parameter, new compare values are calculated. Each key is applied and
+* limited in order, but the values are only marked as changed; the main loop
+* commits the net result of all queued commands at once.
 *
 * Parameters:
 *  key_pressed - command read through terminal
@@ -215,74 +450,506 @@ void uart_event_handler(void *handler_arg, cyhal_uart_event_t event)
 *******************************************************************************/
 void process_key_press(char key_pressed)
 {
-    printf("Pressed key: %c\r\n", key_pressed);
+    /* Waveform keys move the compare pair, see pwm_keys.h */
+    if (pwm_keys_apply(key_pressed, compare_delta, (int32_t)period,
+                       &compare0_value, &compare1_value))
+    {
+        compare_dirty = true;
+        app_log_printf("Pressed key: %c\r\n", key_pressed);
+        return;
+    }
 
     switch(key_pressed)
     {
-        /* Increase duty cycle */
-        case 's':
-            compare0_value += COMPARE_VALUE_DELTA;
-            compare1_value += COMPARE_VALUE_DELTA;
-            if( compare0_value > period )
-                compare0_value = period;
-            if( compare1_value > period )
-                compare1_value = period;
-            break;
-        /* Decrease duty cycle */
-        case 'w':
-            compare0_value -= COMPARE_VALUE_DELTA;
-            compare1_value -= COMPARE_VALUE_DELTA;
-            if( compare0_value < 0 )
-                compare0_value = 0;
-            if( compare1_value < 0 )
-                compare1_value = 0;
-            break;
-        /* Shift waveform to left */
-        case 'a':
-            compare0_value -= COMPARE_VALUE_DELTA;
-            compare1_value += COMPARE_VALUE_DELTA;
-            if( compare0_value < 0 )
-                compare0_value = 0;
-            if( compare1_value > period )
-                compare1_value = period;
-            break;
-        /* Shift waveform to right */
-        case 'd':
-            compare0_value += COMPARE_VALUE_DELTA;
-            compare1_value -= COMPARE_VALUE_DELTA;
-            if( compare0_value > period )
-                compare0_value = period;
-            if( compare1_value < 0 )
-                compare1_value = 0;
-            break;
+        /* Print the counters of the update engine */
+        case 'u':
+            print_update_counters();
+            return;
+#if (LATENCY_TRACE_ENABLE)
+        /* Dump the latency statistics */
+        case 'l':
+            latency_trace_dump();
+            return;
+#endif
+#if (CURRENT_SENSE_ENABLE)
+        /* Print the newest current samples */
+        case 'i':
+            print_currents();
+            return;
+#endif
+#if (PWM_REGULATOR_ENABLE)
+        /* Print the state of the regulator */
+        case 'r':
+            print_regulator();
+            return;
+#endif
+#if (PWM_FAULT_ENABLE)
+        /* Restart the PWM after a fault */
+        case 'f':
+            if (!pwm_fault_clear())
+            {
+                app_log_printf("Fault still active\r\n");
+            }
+            return;
+#endif
+#if (PWM_CAPTURE_ENABLE)
+        /* Print the newest measurement of the input signal */
+        case 'm':
+            print_capture();
+            return;
+#endif
         default:
-            printf("Wrong key pressed !! See below instructions:\r\n");
+            app_log_printf("Pressed key: %c\r\n", key_pressed);
+            app_log_printf("Wrong key pressed !! See below instructions:\r\n");
             print_instructions();
-            return;
+            break;
     }
+}
+
+/*******************************************************************************
+* Function Name: commit_compare_values
+********************************************************************************
+* Summary:
+* Stages the current compare values to the update engine, which writes the
+* buffer registers and issues one compare swap on the next terminal count.
+* The message is queued to the deferred log only after the values are staged.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void commit_compare_values(void)
+{
+    compare_dirty = false;
 
-    printf("Period: %lu\tCompare0: %ld\tCompare1: %ld\r\n",
-          (unsigned long)period, (long)compare0_value,
-          (long)compare1_value);
-
-    /* Set new values for CC0/1 compare buffers */
-    Cy_TCPWM_PWM_SetCompare0BufVal(TCPWM0_GRP1_CNT0_HW,
-                                   TCPWM0_GRP1_CNT0_NUM,
-                                   compare0_value);
-    Cy_TCPWM_PWM_SetCompare1BufVal(TCPWM0_GRP1_CNT0_HW,
-                                   TCPWM0_GRP1_CNT0_NUM,
-                                   compare1_value);
-
-    /* Trigger compare swap with its buffer values */
-    Cy_TCPWM_TriggerCaptureOrSwap_Single(TCPWM0_GRP1_CNT0_HW,
-                                         TCPWM0_GRP1_CNT0_NUM);
+    LATENCY_TRACE_MARK(LATENCY_STAGE_COMPUTE);
+    LATENCY_TRACE_PUBLISH();
+
+    /* Stage new values for period and CC0/1, committed on the next terminal
+     * count */
+    pwm_update_stage_period(period, (uint32_t)compare0_value,
+                            (uint32_t)compare1_value);
+
+    app_log_printf("Period: %lu\tCompare0: %ld\tCompare1: %ld\r\n",
+                   (unsigned long)period, (long)compare0_value,
+                   (long)compare1_value);
+}
+
+/*******************************************************************************
+* Function Name: print_update_counters
+********************************************************************************
+* Summary:
+* Prints the commit counters of the update engine. Overwrites show that
+* values are staged faster than the PWM rate; late commits and missed swaps
+* show that the terminal count ISR did not keep up with the period.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void print_update_counters(void)
+{
+    app_log_printf("Commits: %lu\tOverwrites: %lu\tLate: %lu\tMissed: %lu\r\n",
+                   (unsigned long)pwm_update_get_commit_count(),
+                   (unsigned long)pwm_update_get_overwrite_count(),
+                   (unsigned long)pwm_update_get_late_count(),
+                   (unsigned long)pwm_update_get_missed_count());
+}
+
+/*******************************************************************************
+* Function Name: process_frame
+********************************************************************************
+* Summary:
+* Applies a command received as a binary frame. Absolute and relative
+* setpoints are limited to the period and marked for the next commit. An
+* absolute setpoint that carries a period changes the period as well, so
+* both swap in on the same terminal count. A response frame with the outcome
+* is queued to the log UART.
+*
+* Parameters:
+*  command - decoded frame, including the parser status
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void process_frame(const cmd_protocol_command_t *command)
+{
+    uint8_t response[8];
+    uint32_t response_length;
+    cmd_protocol_status_t status = command->status;
+    bool clamped = false;
+
+    if (CMD_PROTOCOL_STATUS_OK == status)
+    {
+        switch (command->opcode)
+        {
+            case CMD_PROTOCOL_OP_SET_ABSOLUTE:
+                if (0 != command->value2)
+                {
+#if (PWM_UPDATE_PERIOD_SWAP_ENABLE)
+                    /* The pair is given for the new period, the rescale of
+                     * change_period() is overwritten below */
+                    status = change_period(command->value2);
+#else
+                    status = CMD_PROTOCOL_STATUS_UNSUPPORTED;
+#endif
+                }
+                if (CMD_PROTOCOL_STATUS_OK == status)
+                {
+                    compare0_value = clamp_compare(command->value0, &clamped);
+                    compare1_value = clamp_compare(command->value1, &clamped);
+                }
+                break;
+            case CMD_PROTOCOL_OP_SET_RELATIVE:
+                compare0_value = clamp_compare(compare0_value + command->value0,
+                                               &clamped);
+                compare1_value = clamp_compare(compare1_value + command->value1,
+                                               &clamped);
+                break;
+#if (PWM_UPDATE_PERIOD_SWAP_ENABLE)
+            case CMD_PROTOCOL_OP_SET_PERIOD:
+                status = change_period(command->value0);
+                break;
+#endif
+            case CMD_PROTOCOL_OP_SET_SLEW:
+                /* Q8.8 on the wire, Q16.16 in the update engine. Published
+                 * by the commit of the batch. */
+                pwm_update_set_slew((uint32_t)command->value0 << 8U);
+                break;
+#if (PWM_UPDATE_DEAD_TIME_ENABLE)
+            case CMD_PROTOCOL_OP_SET_OUTPUT:
+                status = change_output(command->value0, command->value1);
+                break;
+#endif
+#if (TELEMETRY_ENABLE)
+            case CMD_PROTOCOL_OP_TLM_RATE:
+                telemetry_set_decimation((uint32_t)command->value0);
+                break;
+#endif
+#if (PWM_REGULATOR_ENABLE)
+            case CMD_PROTOCOL_OP_REG_GAINS:
+                pwm_regulator_set_gains((uint32_t)command->value0,
+                                        (uint32_t)command->value1);
+                break;
+            case CMD_PROTOCOL_OP_REG_RUN:
+                status = run_regulator(command->value0, command->value1);
+                break;
+#endif
+#if (PWM_UPDATE_SEQUENCER_ENABLE)
+            case CMD_PROTOCOL_OP_SEQ_STEP:
+                status = store_sequence_step(command);
+                break;
+            case CMD_PROTOCOL_OP_SEQ_RUN:
+                status = run_sequence(command->value0, command->value1);
+                break;
+#endif
+            default:
+                status = CMD_PROTOCOL_STATUS_UNSUPPORTED;
+                break;
+        }
+    }
+
+    if (CMD_PROTOCOL_STATUS_OK == status)
+    {
+        compare_dirty = true;
+
+        if (clamped)
+        {
+            status = CMD_PROTOCOL_STATUS_CLAMPED;
+        }
+    }
+
+    response_length = cmd_protocol_build_response(command->opcode, status,
+                                                  response);
+    app_log_write((const char *)response, response_length);
+}
+
+/*******************************************************************************
+* Function Name: change_period
+********************************************************************************
+* Summary:
+* Changes the switching frequency. The compare values are rescaled to the new
+* period so duty cycle and phase are preserved, and the next commit swaps in
+* the period and both compare values on the same terminal count.
+*
+* Parameters:
+*  new_period - requested period in counter ticks
+*
+* Return:
+*  cmd_protocol_status_t - CMD_PROTOCOL_STATUS_OK, or
+*  CMD_PROTOCOL_STATUS_UNSUPPORTED if the period is out of range
+*
+*******************************************************************************/
+cmd_protocol_status_t change_period(int32_t new_period)
+{
+    if ((new_period < (int32_t)PWM_UPDATE_PERIOD_MIN) ||
+        (new_period > (int32_t)PWM_UPDATE_PERIOD_MAX))
+    {
+        return CMD_PROTOCOL_STATUS_UNSUPPORTED;
+    }
+
+    compare0_value = (int32_t)pwm_math_rescale((uint32_t)compare0_value, period,
+                                               (uint32_t)new_period);
+    compare1_value = (int32_t)pwm_math_rescale((uint32_t)compare1_value, period,
+                                               (uint32_t)new_period);
+    period = (uint32_t)new_period;
+
+    return CMD_PROTOCOL_STATUS_OK;
+}
+
+#if (PWM_UPDATE_DEAD_TIME_ENABLE)
+/*******************************************************************************
+* Function Name: change_output
+********************************************************************************
+* Summary:
+* Changes the dead time and enables or disables the complementary output.
+* The setting goes into the working copy of the update engine and is
+* published by the commit of the current batch, so it swaps in on the same
+* terminal count as the compare values of the batch.
+*
+* Parameters:
+*  dead_time - dead time in counter clocks
+*  complementary - 1 to drive line_compl_out, 0 to hold it low
+*
+* Return:
+*  cmd_protocol_status_t - CMD_PROTOCOL_STATUS_OK, or
+*  CMD_PROTOCOL_STATUS_UNSUPPORTED if a value is out of range
+*
+*******************************************************************************/
+cmd_protocol_status_t change_output(int32_t dead_time, int32_t complementary)
+{
+    if ((dead_time < 0) || (dead_time > (int32_t)PWM_UPDATE_DEAD_TIME_MAX) ||
+        (complementary < 0) || (complementary > 1))
+    {
+        return CMD_PROTOCOL_STATUS_UNSUPPORTED;
+    }
+
+    pwm_update_stage_output((uint32_t)dead_time, (1 == complementary));
+    app_log_printf("Dead time: %ld, complementary: %ld\r\n", (long)dead_time,
+                   (long)complementary);
+
+    return CMD_PROTOCOL_STATUS_OK;
+}
+#endif
+
+#if (PWM_UPDATE_SEQUENCER_ENABLE)
+/*******************************************************************************
+* Function Name: store_sequence_step
+********************************************************************************
+* Summary:
+* Stores one step of the sequence table. The table cannot be changed while
+* the terminal count ISR plays it. The compare values of a step that keeps
+* the current period are checked by run_sequence(), when it is known which
+* period the step runs at.
+*
+* Parameters:
+*  command - decoded SEQ_STEP frame
+*
+* Return:
+*  cmd_protocol_status_t - CMD_PROTOCOL_STATUS_OK, or
+*  CMD_PROTOCOL_STATUS_UNSUPPORTED if the index or a value is out of range or
+*  a sequence is running
+*
+*******************************************************************************/
+cmd_protocol_status_t store_sequence_step(const cmd_protocol_command_t *command)
+{
+    uint32_t step_period = (0 == command->value2) ? PWM_UPDATE_PERIOD_MAX :
+                                                    (uint32_t)command->value2;
+
+    if (pwm_update_is_sequence_running() ||
+        (command->index >= PWM_UPDATE_SEQUENCE_MAX_STEPS) ||
+        (step_period < PWM_UPDATE_PERIOD_MIN) ||
+        ((uint32_t)command->value0 > step_period) ||
+        ((uint32_t)command->value1 > step_period) ||
+        (0 == command->value3))
+    {
+        return CMD_PROTOCOL_STATUS_UNSUPPORTED;
+    }
+
+    sequence_table[command->index].compare0 = (uint16_t)command->value0;
+    sequence_table[command->index].compare1 = (uint16_t)command->value1;
+    sequence_table[command->index].period = (uint16_t)command->value2;
+    sequence_table[command->index].dwell = (uint16_t)command->value3;
+
+    return CMD_PROTOCOL_STATUS_OK;
+}
+
+/*******************************************************************************
+* Function Name: run_sequence
+********************************************************************************
+* Summary:
+* Starts the first steps of the sequence table, or stops the running
+* sequence. The end of the sequence is reported by report_sequence_done().
+*
+* Parameters:
+*  count - number of steps to play, 0 to stop the running sequence
+*  repeat - number of passes, 0 to repeat until stopped
+*
+* Return:
+*  cmd_protocol_status_t - CMD_PROTOCOL_STATUS_OK, or
+*  CMD_PROTOCOL_STATUS_UNSUPPORTED if the count is out of range, a step has
+*  no dwell or a compare value beyond the period it runs at, or a sequence
+*  is already running
+*
+*******************************************************************************/
+cmd_protocol_status_t run_sequence(int32_t count, int32_t repeat)
+{
+    if (0 == count)
+    {
+        pwm_update_stop_sequence();
+        return CMD_PROTOCOL_STATUS_OK;
+    }
+
+    if ((count > (int32_t)PWM_UPDATE_SEQUENCE_MAX_STEPS) ||
+        !check_sequence((uint32_t)count, (1 != repeat)) ||
+        !pwm_update_run_sequence(sequence_table, (uint32_t)count,
+                                 (uint32_t)repeat))
+    {
+        return CMD_PROTOCOL_STATUS_UNSUPPORTED;
+    }
+
+    app_log_printf("Sequence: %ld steps, %ld passes\r\n", (long)count,
+                   (long)repeat);
+
+    return CMD_PROTOCOL_STATUS_OK;
+}
+
+/*******************************************************************************
+* Function Name: check_sequence
+********************************************************************************
+* Summary:
+* Checks the compare values of the first steps of the sequence table against
+* the period each step runs at. A step with period 0 keeps the period of the
+* step before it, and the first steps keep the current period on the first
+* pass and the last period of the table on every further pass.
+*
+* Parameters:
+*  count - number of steps to play, at least 1
+*  repeated - true if the sequence plays more than one pass
+*
+* Return:
+*  bool - true if every compare value fits into its period
+*
+*******************************************************************************/
+bool check_sequence(uint32_t count, bool repeated)
+{
+    uint32_t active_period = period;
+    uint32_t passes = repeated ? 2U : 1U;
+    uint32_t pass;
+    uint32_t index;
+
+    /* From the second pass on the state at the start of a pass is the same,
+     * so two passes cover every period a step can run at */
+    for (pass = 0U; pass < passes; pass++)
+    {
+        for (index = 0U; index < count; index++)
+        {
+#if (PWM_UPDATE_PERIOD_SWAP_ENABLE)
+            if (0U != sequence_table[index].period)
+            {
+                active_period = sequence_table[index].period;
+            }
+#endif
+            if ((sequence_table[index].compare0 > active_period) ||
+                (sequence_table[index].compare1 > active_period))
+            {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: report_sequence_done
+********************************************************************************
+* Summary:
+* Reports the end of a sequence with an unsolicited SEQ_RUN response frame
+* and a log message. The waveform is back at the last staged values.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void report_sequence_done(void)
+{
+    uint8_t response[8];
+    uint32_t response_length;
+
+    if (pwm_update_get_sequence_done())
+    {
+        response_length = cmd_protocol_build_response(CMD_PROTOCOL_OP_SEQ_RUN,
+                                                      CMD_PROTOCOL_STATUS_OK,
+                                                      response);
+        app_log_write((const char *)response, response_length);
+        app_log_printf("Sequence done\r\n");
+    }
+}
+#endif /* PWM_UPDATE_SEQUENCER_ENABLE */
+
+/*******************************************************************************
+* Function Name: clamp_compare
+********************************************************************************
+* Summary:
+* Limits a compare value to the range 0 to period.
+*
+* Parameters:
+*  value - requested compare value
+*  clamped - set to true if the value had to be limited, otherwise untouched
+*
+* Return:
+*  int32_t - compare value within range
+*
+*******************************************************************************/
+int32_t clamp_compare(int32_t value, bool *clamped)
+{
+    int32_t limited = pwm_math_clamp(value, (int32_t)period);
+
+    *clamped |= (limited != value);
+
+    return limited;
+}
+
+/*******************************************************************************
+* Function Name: print_banner
+********************************************************************************
+* Summary:
+* Clears the screen and queues the title and the instructions to the
+* deferred log, once.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void print_banner(void)
+{
+    if (banner_pending)
+    {
+        banner_pending = false;
+        app_log_write(banner, sizeof(banner) - 1U);
+        print_instructions();
+    }
 }
 
 /*******************************************************************************
 * Function Name: print_instructions
 ********************************************************************************
 * Summary:
-* Prints set of instructions.
+* Queues the set of instructions to the deferred log.
 *
 * Parameters:
 *  void
@@ -293,12 +960,229 @@ void process_key_press(char key_pressed)
 *******************************************************************************/
 void print_instructions(void)
 {
-    printf("====================================================\r\n"
+    static const char instructions[] =
+           "====================================================\r\n"
            "Instructions:\r\n"
            "====================================================\r\n"
            "Press 'w' : To increase the duty cycle\r\n"
            "Press 's' : To decrease the duty cycle\r\n"
            "Press 'a' : To shift waveform towards left\r\n"
            "Press 'd' : To shift waveform towards right\r\n"
-           "====================================================\r\n");
+           "====================================================\r\n";
+
+    app_log_write(instructions, sizeof(instructions) - 1U);
+}
+
+#if (PWM_REGULATOR_ENABLE)
+/*******************************************************************************
+* Function Name: run_regulator
+********************************************************************************
+* Summary:
+* Starts the regulator at the duty cycle of the working compare values, or
+* changes the setpoint of the running regulator, or stops it. After the stop
+* the waveform returns to the working compare values.
+*
+* Parameters:
+*  setpoint - target of the measurement in ADC counts
+*  run - 0 to stop the regulator, any other value to run it
+*
+* Return:
+*  cmd_protocol_status_t - CMD_PROTOCOL_STATUS_OK, or
+*  CMD_PROTOCOL_STATUS_UNSUPPORTED if the setpoint is out of range
+*
+*******************************************************************************/
+cmd_protocol_status_t run_regulator(int32_t setpoint, int32_t run)
+{
+    pwm_math_t math;
+
+    if (0 == run)
+    {
+        pwm_regulator_stop();
+        return CMD_PROTOCOL_STATUS_OK;
+    }
+
+    if (setpoint > (int32_t)PWM_REGULATOR_MEASUREMENT_MAX)
+    {
+        return CMD_PROTOCOL_STATUS_UNSUPPORTED;
+    }
+
+    pwm_math_init(&math, period);
+    pwm_regulator_start((uint32_t)setpoint,
+                        pwm_math_duty(&math, (uint32_t)compare0_value,
+                                      (uint32_t)compare1_value));
+
+    return CMD_PROTOCOL_STATUS_OK;
+}
+
+/*******************************************************************************
+* Function Name: print_regulator
+********************************************************************************
+* Summary:
+* Prints whether the regulator runs, and the measurement and duty cycle of
+* its last period.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void print_regulator(void)
+{
+    app_log_printf("Regulator: %s\tMeasured: %lu\tDuty: %ld/32768\r\n",
+                   pwm_regulator_is_running() ? "on" : "off",
+                   (unsigned long)pwm_regulator_get_measurement(),
+                   (long)pwm_regulator_get_duty());
+}
+#endif
+
+#if (CURRENT_SENSE_ENABLE)
+/*******************************************************************************
+* Function Name: current_sense_handler
+********************************************************************************
+* Summary:
+* Current sampling callback, runs in the DMA interrupt once per half of the
+* sample buffer. Keeps the newest set of the half for print_currents(). A
+* control loop would consume the whole half here.
+*
+* Parameters:
+*  sets - completed sample sets, oldest first
+*  count - number of sets
+*  callback_arg - not used
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void current_sense_handler(const current_sense_set_t *sets, uint32_t count,
+                           void *callback_arg)
+{
+    uint32_t channel;
+
+    (void)callback_arg;
+
+    for (channel = 0U; channel < CURRENT_SENSE_CHANNELS; channel++)
+    {
+        latest_currents.sample[channel] = sets[count - 1U].sample[channel];
+    }
+}
+
+/*******************************************************************************
+* Function Name: print_currents
+********************************************************************************
+* Summary:
+* Prints the newest raw SAR result of every current channel and the number
+* of sample buffer halves lost to interrupt latency.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void print_currents(void)
+{
+    uint32_t channel;
+
+    for (channel = 0U; channel < CURRENT_SENSE_CHANNELS; channel++)
+    {
+        app_log_printf("Current %u: %u\r\n", (unsigned int)channel,
+                       (unsigned int)latest_currents.sample[channel]);
+    }
+    app_log_printf("Current overruns: %u\r\n",
+                   (unsigned int)current_sense_get_overrun_count());
+}
+#endif /* CURRENT_SENSE_ENABLE */
+
+#if (PWM_CAPTURE_ENABLE)
+/*******************************************************************************
+* Function Name: pwm_capture_handler
+********************************************************************************
+* Summary:
+* Capture callback, runs in the DMA interrupt once per half of the capture
+* buffer. Keeps the newest cycle of the half for print_capture().
+*
+* Parameters:
+*  samples - captured cycles, oldest first
+*  count - number of cycles
+*  callback_arg - not used
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void pwm_capture_handler(const pwm_capture_sample_t *samples, uint32_t count,
+                         void *callback_arg)
+{
+    (void)callback_arg;
+
+    latest_capture.rise = samples[count - 1U].rise;
+    latest_capture.previous_rise = samples[count - 1U].previous_rise;
+    latest_capture.fall = samples[count - 1U].fall;
+}
+
+/*******************************************************************************
+* Function Name: print_capture
+********************************************************************************
+* Summary:
+* Prints the period and high time of the newest captured input cycle. In the
+* loop-back test the period must be twice the PWM period, as the counter of
+* the center-aligned PWM counts up and down.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void print_capture(void)
+{
+    pwm_capture_sample_t sample;
+    uint32_t saved_intr = Cy_SysLib_EnterCriticalSection();
+
+    sample.rise = latest_capture.rise;
+    sample.previous_rise = latest_capture.previous_rise;
+    sample.fall = latest_capture.fall;
+    Cy_SysLib_ExitCriticalSection(saved_intr);
+
+    app_log_printf("Capture period: %lu (PWM: %lu), high time: %lu\r\n",
+                   (unsigned long)pwm_capture_period(&sample),
+                   (unsigned long)(2U * period),
+                   (unsigned long)pwm_capture_high_time(&sample));
+}
+#endif /* PWM_CAPTURE_ENABLE */
+
+#if (PWM_FAULT_ENABLE)
+/*******************************************************************************
+* Function Name: report_fault
+********************************************************************************
+* Summary:
+* Prints the snapshot of a newly latched fault. The outputs are already in
+* their disabled state; press 'f' to restart the PWM.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void report_fault(void)
+{
+    pwm_fault_snapshot_t snapshot;
+
+    if (pwm_fault_get_snapshot(&snapshot))
+    {
+        app_log_printf("FAULT %lu: counter %lu, CC0 %lu, CC1 %lu, status "
+                       "0x%08lx. Press 'f' to restart.\r\n",
+                       (unsigned long)snapshot.count,
+                       (unsigned long)snapshot.counter,
+                       (unsigned long)snapshot.compare0,
+                       (unsigned long)snapshot.compare1,
+                       (unsigned long)snapshot.status);
+    }
 }
+#endif /* PWM_FAULT_ENABLE */
@@ -0,0 +1,328 @@
+/*******************************************************************************
+* File Name:   pwm_capture.c
+*
+* Description: Capture companion on the neighbouring counter. The counter runs
+* free from the same clock as the PWM and captures the rising edges of an
+* input signal into CC0 (the previous capture moves to CC0_BUFF) and the
+* falling edges into CC1. On every falling edge a DataWire channel copies
+* CC0, CC0_BUFF and CC1 into a circular buffer, which gives the period and
+* the high time of each input cycle at full counter resolution without CPU
+* involvement. Wiring the PWM output to the input makes a loop-back test.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2020-2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include "cy_pdl.h"
+#include "cybsp.h"
+#include "app_config.h"
+#include "pwm_capture.h"
+#include "pwm_regs.h"
+#include "pwm_clock.h"
+
+#if (PWM_CAPTURE_ENABLE)
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define SAMPLE_WORDS            (3UL) /* CC0, CC0_BUFF and CC1 */
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+static void pwm_capture_descriptor_init(uint32_t half);
+static void pwm_capture_dma_isr(void);
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+/* Circular buffer written by the DMA, first half then second half */
+static pwm_capture_sample_t capture_ring[2U * PWM_CAPTURE_SAMPLES_PER_HALF];
+static cy_stc_dma_descriptor_t capture_descriptor[2]; /* One per half */
+static pwm_capture_callback_t capture_callback = NULL;
+static void *capture_callback_arg = NULL;
+
+/*******************************************************************************
+* Function Name: pwm_capture_init
+********************************************************************************
+* Summary:
+* Configures the capture counter, clocks it from the PWM clock divider so
+* both counters tick at the same rate, routes the input pin to both of
+* its capture inputs, and sets up the DataWire channel that is triggered by
+* the falling edge capture. Capturing starts with pwm_capture_start().
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void pwm_capture_init(void)
+{
+    const cy_stc_tcpwm_counter_config_t counter_config =
+    {
+        .period = PWM_CAPTURE_COUNTER_MASK,
+        .clockPrescaler = CY_TCPWM_COUNTER_PRESCALER_DIVBY_1,
+        .runMode = CY_TCPWM_COUNTER_CONTINUOUS,
+        .countDirection = CY_TCPWM_COUNTER_COUNT_UP,
+        .compareOrCapture = CY_TCPWM_COUNTER_MODE_CAPTURE,
+        .compare0 = 0UL,
+        .compare1 = 0UL,
+        .enableCompareSwap = false,
+        .interruptSources = CY_TCPWM_INT_NONE,
+        .captureInputMode = CY_TCPWM_INPUT_RISINGEDGE,
+        .captureInput = PWM_CAPTURE_INPUT,
+        .reloadInputMode = CY_TCPWM_INPUT_RISINGEDGE,
+        .reloadInput = CY_TCPWM_INPUT_0,
+        .startInputMode = CY_TCPWM_INPUT_RISINGEDGE,
+        .startInput = CY_TCPWM_INPUT_0,
+        .stopInputMode = CY_TCPWM_INPUT_RISINGEDGE,
+        .stopInput = CY_TCPWM_INPUT_0,
+        .countInputMode = CY_TCPWM_INPUT_LEVEL,
+        .countInput = CY_TCPWM_INPUT_1,
+        .capture1InputMode = CY_TCPWM_INPUT_FALLINGEDGE,
+        .capture1Input = PWM_CAPTURE_INPUT,
+        .enableCompare1Swap = false,
+        .compare2 = 0UL,
+        .compare3 = 0UL,
+        .trigger0Event = CY_TCPWM_CNT_TRIGGER_ON_CC1_MATCH,
+        .trigger1Event = CY_TCPWM_CNT_TRIGGER_ON_DISABLED
+    };
+    const cy_stc_dma_channel_config_t channel_config =
+    {
+        .descriptor = &capture_descriptor[0],
+        .preemptable = false,
+        .priority = 0U,
+        .enable = false,
+        .bufferable = false
+    };
+    const cy_stc_sysint_t dma_irq_cfg =
+    {
+        .intrSrc = PWM_CAPTURE_DW_IRQ,
+        .intrPriority = PWM_CAPTURE_DW_IRQ_PRIORITY
+    };
+
+    pwm_clock_assign(PWM_CAPTURE_PCLK);
+    if (CY_TCPWM_SUCCESS != Cy_TCPWM_Counter_Init(PWM_CAPTURE_HW,
+                                                  PWM_CAPTURE_NUM,
+                                                  &counter_config))
+    {
+        CY_ASSERT(0);
+    }
+
+    /* The pin feeds the trigger multiplexer through its HSIOM function */
+    Cy_GPIO_Pin_FastInit(PWM_CAPTURE_PORT, PWM_CAPTURE_PIN, CY_GPIO_DM_HIGHZ,
+                         0UL, PWM_CAPTURE_HSIOM);
+
+    /* The input is passed as a level, the counter detects the edges.
+     * Capture (CC1 event) -> DMA request. */
+    if ((CY_RSLT_SUCCESS != Cy_TrigMux_Connect(PWM_CAPTURE_INPUT_TRIG_IN,
+                                               PWM_CAPTURE_INPUT_TRIG_OUT,
+                                               false, TRIGGER_TYPE_LEVEL)) ||
+        (CY_RSLT_SUCCESS != Cy_TrigMux_Connect(PWM_CAPTURE_DMA_TRIG_IN,
+                                               PWM_CAPTURE_DMA_TRIG_OUT,
+                                               false, TRIGGER_TYPE_EDGE)))
+    {
+        CY_ASSERT(0);
+    }
+
+    pwm_capture_descriptor_init(0U);
+    pwm_capture_descriptor_init(1U);
+    Cy_DMA_Enable(PWM_CAPTURE_DW);
+    if (CY_DMA_SUCCESS != Cy_DMA_Channel_Init(PWM_CAPTURE_DW,
+                                              PWM_CAPTURE_DW_CHANNEL,
+                                              &channel_config))
+    {
+        CY_ASSERT(0);
+    }
+    Cy_DMA_Channel_SetInterruptMask(PWM_CAPTURE_DW, PWM_CAPTURE_DW_CHANNEL,
+                                    CY_DMA_INTR_MASK);
+
+    if (CY_SYSINT_SUCCESS != Cy_SysInt_Init(&dma_irq_cfg, pwm_capture_dma_isr))
+    {
+        CY_ASSERT(0);
+    }
+    NVIC_EnableIRQ(dma_irq_cfg.intrSrc);
+}
+
+/*******************************************************************************
+* Function Name: pwm_capture_register_callback
+********************************************************************************
+* Summary:
+* Registers the function called each time a half of the circular buffer is
+* filled with captured cycles.
+*
+* Parameters:
+*  callback - function to call, NULL to disable
+*  callback_arg - argument passed to the callback
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void pwm_capture_register_callback(pwm_capture_callback_t callback,
+                                   void *callback_arg)
+{
+    capture_callback = NULL;
+    __DMB();
+    capture_callback_arg = callback_arg;
+    __DMB();
+    capture_callback = callback;
+}
+
+/*******************************************************************************
+* Function Name: pwm_capture_start
+********************************************************************************
+* Summary:
+* Enables the DataWire channel and starts the capture counter. The first
+* sample only has a valid period once two rising edges were captured.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void pwm_capture_start(void)
+{
+    Cy_DMA_Channel_SetDescriptor(PWM_CAPTURE_DW, PWM_CAPTURE_DW_CHANNEL,
+                                 &capture_descriptor[0]);
+    Cy_DMA_Channel_Enable(PWM_CAPTURE_DW, PWM_CAPTURE_DW_CHANNEL);
+    Cy_TCPWM_Counter_Enable(PWM_CAPTURE_HW, PWM_CAPTURE_NUM);
+    Cy_TCPWM_TriggerStart_Single(PWM_CAPTURE_HW, PWM_CAPTURE_NUM);
+}
+
+/*******************************************************************************
+* Function Name: pwm_capture_stop
+********************************************************************************
+* Summary:
+* Stops the capture counter and the DataWire channel. A partly filled half
+* is discarded.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void pwm_capture_stop(void)
+{
+    Cy_TCPWM_Counter_Disable(PWM_CAPTURE_HW, PWM_CAPTURE_NUM);
+    Cy_DMA_Channel_Disable(PWM_CAPTURE_DW, PWM_CAPTURE_DW_CHANNEL);
+}
+
+/*******************************************************************************
+* Function Name: pwm_capture_descriptor_init
+********************************************************************************
+* Summary:
+* Sets up the 2D descriptor of one half. Each falling edge capture runs one X
+* loop, which copies the consecutive CC0, CC0_BUFF and CC1 registers into one
+* sample; the Y loop walks the samples of the half. Both descriptors chain to
+* each other, so the buffer is circular.
+*
+* Parameters:
+*  half - descriptor index, 0 or 1
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void pwm_capture_descriptor_init(uint32_t half)
+{
+    const cy_stc_dma_descriptor_config_t descriptor_config =
+    {
+        .retrigger       = CY_DMA_RETRIG_IM,
+        .interruptType   = CY_DMA_DESCR,
+        .triggerOutType  = CY_DMA_DESCR,
+        .channelState    = CY_DMA_CHANNEL_ENABLED,
+        .triggerInType   = CY_DMA_X_LOOP,
+        .dataSize        = CY_DMA_WORD,
+        .srcTransferSize = CY_DMA_TRANSFER_SIZE_DATA,
+        .dstTransferSize = CY_DMA_TRANSFER_SIZE_DATA,
+        .descriptorType  = CY_DMA_2D_TRANSFER,
+        .srcAddress      = (void *)&PWM_REGS_CC0(PWM_CAPTURE_HW,
+                                                 PWM_CAPTURE_NUM),
+        .dstAddress      = (void *)&capture_ring[half *
+                                                 PWM_CAPTURE_SAMPLES_PER_HALF],
+        .srcXincrement   = 1,
+        .dstXincrement   = 1,
+        .xCount          = SAMPLE_WORDS,
+        .srcYincrement   = 0,
+        .dstYincrement   = (int32_t)SAMPLE_WORDS,
+        .yCount          = PWM_CAPTURE_SAMPLES_PER_HALF,
+        .nextDescriptor  = &capture_descriptor[half ^ 1U]
+    };
+
+    if (CY_DMA_SUCCESS != Cy_DMA_Descriptor_Init(&capture_descriptor[half],
+                                                 &descriptor_config))
+    {
+        CY_ASSERT(0);
+    }
+}
+
+/*******************************************************************************
+* Function Name: pwm_capture_dma_isr
+********************************************************************************
+* Summary:
+* DataWire completion handler, runs once per filled half. The half that just
+* completed is the one the channel is not working on.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void pwm_capture_dma_isr(void)
+{
+    uint32_t done_half;
+
+    Cy_DMA_Channel_ClearInterrupt(PWM_CAPTURE_DW, PWM_CAPTURE_DW_CHANNEL);
+
+    done_half = (Cy_DMA_Channel_GetCurrentDescriptor(PWM_CAPTURE_DW,
+                                                     PWM_CAPTURE_DW_CHANNEL)
+                 == &capture_descriptor[1]) ? 0U : 1U;
+
+    if (NULL != capture_callback)
+    {
+        capture_callback(&capture_ring[done_half * PWM_CAPTURE_SAMPLES_PER_HALF],
+                         PWM_CAPTURE_SAMPLES_PER_HALF, capture_callback_arg);
+    }
+}
+
+#endif /* PWM_CAPTURE_ENABLE */
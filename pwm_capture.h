@@ -0,0 +1,117 @@
+/*******************************************************************************
+* File Name:   pwm_capture.h
+*
+* Description: Capture companion on the neighbouring counter. The counter runs
+* free from the same clock as the PWM and captures the rising edges of an
+* input signal into CC0 (the previous capture moves to CC0_BUFF) and the
+* falling edges into CC1. On every falling edge a DataWire channel copies
+* CC0, CC0_BUFF and CC1 into a circular buffer, which gives the period and
+* the high time of each input cycle at full counter resolution without CPU
+* involvement. Wiring the PWM output to the input makes a loop-back test.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2020-2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef PWM_CAPTURE_H_
+#define PWM_CAPTURE_H_
+
+#include "cy_pdl.h"
+#include "app_config.h"
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+/* One input cycle, copied from the capture registers in register order */
+typedef struct
+{
+    uint32_t rise;          /* CC0: counter at the last rising edge */
+    uint32_t previous_rise; /* CC0_BUFF: counter at the rising edge before */
+    uint32_t fall;          /* CC1: counter at the falling edge */
+} pwm_capture_sample_t;
+
+/* Called from the DMA interrupt with the samples of the half that completed.
+ * The samples are overwritten again one half later. */
+typedef void (*pwm_capture_callback_t)(const pwm_capture_sample_t *samples,
+                                       uint32_t count, void *callback_arg);
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+void pwm_capture_init(void);
+void pwm_capture_register_callback(pwm_capture_callback_t callback,
+                                   void *callback_arg);
+void pwm_capture_start(void);
+void pwm_capture_stop(void);
+
+/*******************************************************************************
+* Function Name: pwm_capture_period
+********************************************************************************
+* Summary:
+* Returns the period of an input cycle. The counter wraps at its 16-bit
+* width, so the difference is taken modulo 2^16; periods must be shorter than
+* 65536 counter clocks.
+*
+* Parameters:
+*  sample - captured cycle
+*
+* Return:
+*  uint32_t - period in counter clocks
+*
+*******************************************************************************/
+static inline uint32_t pwm_capture_period(const pwm_capture_sample_t *sample)
+{
+    return (sample->rise - sample->previous_rise) & PWM_CAPTURE_COUNTER_MASK;
+}
+
+/*******************************************************************************
+* Function Name: pwm_capture_high_time
+********************************************************************************
+* Summary:
+* Returns the high time of an input cycle, from its rising to its falling
+* edge, modulo the counter width.
+*
+* Parameters:
+*  sample - captured cycle
+*
+* Return:
+*  uint32_t - high time in counter clocks
+*
+*******************************************************************************/
+static inline uint32_t pwm_capture_high_time(const pwm_capture_sample_t *sample)
+{
+    return (sample->fall - sample->rise) & PWM_CAPTURE_COUNTER_MASK;
+}
+
+#endif /* PWM_CAPTURE_H_ */
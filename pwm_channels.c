@@ -0,0 +1,190 @@
+/*******************************************************************************
+* File Name:   pwm_channels.c
+*
+* Description: Multi-channel dual compare PWM manager. Groups several
+* counters of one TCPWM block, such as the three phases of an inverter, into
+* a channel set. The per-channel compare values are kept as a struct of
+* arrays and all channels are committed with one grouped swap, so every
+* phase changes on the same period boundary. Like the rest of the example it
+* needs TCPWM v2, the only version with a second compare register.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2020-2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include "cy_pdl.h"
+#include "pwm_channels.h"
+
+#if (CY_IP_MXTCPWM_VERSION == 1U)
+#error "pwm_channels.c needs TCPWM v2"
+#endif
+
+/*******************************************************************************
+* Function Name: pwm_channels_init
+********************************************************************************
+* Summary:
+* Builds a channel set from counters that are already initialized in PWM
+* mode with compare swap enabled. The staged values start from the current
+* compare buffer contents. The swap input of every counter is connected to
+* PWM_CHANNELS_SWAP_TRIG_LINE and the start input to
+* PWM_CHANNELS_START_TRIG_LINE.
+*
+* Parameters:
+*  set - channel set object
+*  base - TCPWM block base address
+*  cnt_num - counter numbers, one per channel
+*  count - number of channels, at most PWM_CHANNELS_MAX
+*
+* Return:
+*  bool - false if the channel count is invalid
+*
+*******************************************************************************/
+bool pwm_channels_init(pwm_channel_set_t *set, TCPWM_Type *base,
+                       const uint32_t *cnt_num, uint32_t count)
+{
+    uint32_t ch;
+
+    if ((0U == count) || (count > PWM_CHANNELS_MAX))
+    {
+        return false;
+    }
+
+    set->base = base;
+    set->count = count;
+
+    for (ch = 0U; ch < count; ch++)
+    {
+        set->cnt_num[ch] = cnt_num[ch];
+        set->compare0[ch] = Cy_TCPWM_PWM_GetCompare0BufVal(base, cnt_num[ch]);
+        set->compare1[ch] = Cy_TCPWM_PWM_GetCompare1BufVal(base, cnt_num[ch]);
+        Cy_TCPWM_InputTriggerSetup(base, cnt_num[ch],
+                                   CY_TCPWM_INPUT_TR_CAPTURE0,
+                                   CY_TCPWM_INPUT_RISINGEDGE,
+                                   PWM_CHANNELS_SWAP_INPUT);
+        Cy_TCPWM_InputTriggerSetup(base, cnt_num[ch], CY_TCPWM_INPUT_TR_START,
+                                   CY_TCPWM_INPUT_RISINGEDGE,
+                                   PWM_CHANNELS_START_INPUT);
+    }
+
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: pwm_channels_set
+********************************************************************************
+* Summary:
+* Stages the compare pair of one channel. Nothing is written to the hardware
+* until pwm_channels_commit() is called.
+*
+* Parameters:
+*  set - channel set object
+*  channel - channel index
+*  compare0 - new CC0 value
+*  compare1 - new CC1 value
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void pwm_channels_set(pwm_channel_set_t *set, uint32_t channel,
+                      uint32_t compare0, uint32_t compare1)
+{
+    CY_ASSERT(channel < set->count);
+
+    set->compare0[channel] = compare0;
+    set->compare1[channel] = compare1;
+}
+
+/*******************************************************************************
+* Function Name: pwm_channels_commit
+********************************************************************************
+* Summary:
+* Writes the staged pairs of all channels to their buffer registers and
+* triggers one grouped swap. The swap takes effect on the next terminal
+* count, so calling this from the terminal count interrupt of one channel
+* gives all channels the same commit edge.
+*
+* Parameters:
+*  set - channel set object
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void pwm_channels_commit(const pwm_channel_set_t *set)
+{
+    uint32_t ch;
+
+    for (ch = 0U; ch < set->count; ch++)
+    {
+        Cy_TCPWM_PWM_SetCompare0BufVal(set->base, set->cnt_num[ch],
+                                       set->compare0[ch]);
+        Cy_TCPWM_PWM_SetCompare1BufVal(set->base, set->cnt_num[ch],
+                                       set->compare1[ch]);
+    }
+
+    /* TCPWM v2 has no block-wide command register. One software trigger
+     * of the all-counter line reaches the swap input of every channel on
+     * the same clock edge. */
+    if (CY_RSLT_SUCCESS != Cy_TrigMux_SwTrigger(PWM_CHANNELS_SWAP_TRIG_LINE,
+                                                CY_TRIGGER_TWO_CYCLES))
+    {
+        CY_ASSERT(0);
+    }
+}
+
+/*******************************************************************************
+* Function Name: pwm_channels_start
+********************************************************************************
+* Summary:
+* Starts all channels on the same clock cycle with one software trigger of
+* the all-counter start line, so that their periods are aligned.
+*
+* Parameters:
+*  set - channel set object
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void pwm_channels_start(const pwm_channel_set_t *set)
+{
+    (void)set; /* The start inputs were connected by pwm_channels_init() */
+
+    if (CY_RSLT_SUCCESS != Cy_TrigMux_SwTrigger(PWM_CHANNELS_START_TRIG_LINE,
+                                                CY_TRIGGER_TWO_CYCLES))
+    {
+        CY_ASSERT(0);
+    }
+}
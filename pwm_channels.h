@@ -0,0 +1,73 @@
+/*******************************************************************************
+* File Name:   pwm_channels.h
+*
+* Description: Multi-channel dual compare PWM manager. Groups several
+* counters of one TCPWM block, such as the three phases of an inverter, into
+* a channel set. The per-channel compare values are kept as a struct of
+* arrays and all channels are committed with one grouped swap, so every
+* phase changes on the same period boundary.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2020-2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef PWM_CHANNELS_H_
+#define PWM_CHANNELS_H_
+
+#include "cy_pdl.h"
+#include "app_config.h"
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+typedef struct
+{
+    TCPWM_Type *base;                       /* TCPWM block of all channels */
+    uint32_t count;                         /* Number of channels in use */
+    uint32_t cnt_num[PWM_CHANNELS_MAX];     /* Counter of each channel */
+    uint32_t compare0[PWM_CHANNELS_MAX];    /* Staged CC0 of each channel */
+    uint32_t compare1[PWM_CHANNELS_MAX];    /* Staged CC1 of each channel */
+} pwm_channel_set_t;
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+bool pwm_channels_init(pwm_channel_set_t *set, TCPWM_Type *base,
+                       const uint32_t *cnt_num, uint32_t count);
+void pwm_channels_set(pwm_channel_set_t *set, uint32_t channel,
+                      uint32_t compare0, uint32_t compare1);
+void pwm_channels_commit(const pwm_channel_set_t *set);
+void pwm_channels_start(const pwm_channel_set_t *set);
+
+#endif /* PWM_CHANNELS_H_ */
@@ -0,0 +1,229 @@
+/*******************************************************************************
+* File Name:   pwm_clock.c
+*
+* Description: Counter clock selection with automatic tick scaling. By
+* default the counter runs from the PWM_CLK divider of the design file. With
+* PWM_CLOCK_HIRES_ENABLE it runs from a 16-bit divider allocated at startup
+* instead. Either way, the period and compare registers programmed from the
+* design file are scaled from PWM_CLOCK_REFERENCE_HZ to the actual counter
+* clock before the PWM starts.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include "cy_pdl.h"
+#include "cyhal.h"
+#include "cybsp.h"
+#include "app_config.h"
+#include "pwm_math.h"
+#include "pwm_clock.h"
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+static cy_en_divider_types_t clock_div_type = PWM_CLK_HW; /* Counter divider */
+static uint32_t clock_div_num = PWM_CLK_NUM;
+static uint32_t clock_hz = PWM_CLOCK_REFERENCE_HZ; /* Counter clock */
+#if (PWM_CLOCK_HIRES_ENABLE)
+static cyhal_clock_t hires_clock; /* Divider allocated for the counter */
+#endif
+
+/*******************************************************************************
+* Function Name: pwm_clock_scale
+********************************************************************************
+* Summary:
+* Scales a compare value of the design file by new_ticks / old_ticks and
+* limits it to the period.
+*
+* Parameters:
+*  value - compare value of the design file
+*  old_ticks - divisor of the scale ratio
+*  new_ticks - multiplier of the scale ratio
+*  period - period the value is used with
+*
+* Return:
+*  uint32_t - scaled compare value
+*
+*******************************************************************************/
+static uint32_t pwm_clock_scale(uint32_t value, uint32_t old_ticks,
+                                uint32_t new_ticks, uint32_t period)
+{
+    value = pwm_math_rescale(value, old_ticks, new_ticks);
+
+    return (value > period) ? period : value;
+}
+
+/*******************************************************************************
+* Function Name: pwm_clock_init
+********************************************************************************
+* Summary:
+* Selects the counter clock and scales the period and compare registers from
+* the reference clock to it. Call it after the counter is initialized from
+* the design file and before the values are read back or the counter starts.
+* A period that would exceed PWM_UPDATE_PERIOD_MAX at the counter clock is
+* limited to it, with the compare values scaled to the limited period.
+*
+* Parameters:
+*  base - TCPWM block base address
+*  cnt_num - counter number within the block
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void pwm_clock_init(TCPWM_Type *base, uint32_t cnt_num)
+{
+    uint32_t reference_period;
+    uint32_t period;
+    uint32_t ratio;
+
+#if (PWM_CLOCK_HIRES_ENABLE)
+    cy_rslt_t result;
+
+    /* Allocated through the HAL so that it cannot collide with the dividers
+     * the HAL drivers use */
+    result = cyhal_clock_allocate(&hires_clock,
+                                  CYHAL_CLOCK_BLOCK_PERIPHERAL_16BIT);
+    if (CY_RSLT_SUCCESS == result)
+    {
+        result = cyhal_clock_set_divider(&hires_clock,
+                                         PWM_CLOCK_HIRES_DIVIDER);
+    }
+    if (CY_RSLT_SUCCESS == result)
+    {
+        result = cyhal_clock_set_enabled(&hires_clock, true, false);
+    }
+    if (CY_RSLT_SUCCESS != result)
+    {
+        CY_ASSERT(0);
+    }
+    clock_div_type = CY_SYSCLK_DIV_16_BIT;
+    clock_div_num = hires_clock.channel;
+    pwm_clock_assign(PWM_CLOCK_PCLK);
+#endif
+
+    clock_hz = Cy_SysClk_PeriphGetFrequency(clock_div_type, clock_div_num);
+    if (PWM_CLOCK_REFERENCE_HZ == clock_hz)
+    {
+        return;
+    }
+
+    reference_period = Cy_TCPWM_PWM_GetPeriod0(base, cnt_num);
+    period = pwm_clock_ticks(reference_period);
+    if ((0U == reference_period) || (period <= PWM_UPDATE_PERIOD_MAX))
+    {
+        reference_period = PWM_CLOCK_REFERENCE_HZ;
+        ratio = clock_hz;
+    }
+    else
+    {
+        /* The scaled period does not fit the counter: run at the longest
+         * period instead and scale the compare values to it, so the duty
+         * cycle stays the same at a higher switching frequency */
+        period = PWM_UPDATE_PERIOD_MAX;
+        ratio = period;
+    }
+
+    Cy_TCPWM_PWM_SetPeriod0(base, cnt_num, period);
+    Cy_TCPWM_PWM_SetCompare0Val(base, cnt_num,
+        pwm_clock_scale(Cy_TCPWM_PWM_GetCompare0Val(base, cnt_num),
+                        reference_period, ratio, period));
+    Cy_TCPWM_PWM_SetCompare0BufVal(base, cnt_num,
+        pwm_clock_scale(Cy_TCPWM_PWM_GetCompare0BufVal(base, cnt_num),
+                        reference_period, ratio, period));
+    Cy_TCPWM_PWM_SetCompare1Val(base, cnt_num,
+        pwm_clock_scale(Cy_TCPWM_PWM_GetCompare1Val(base, cnt_num),
+                        reference_period, ratio, period));
+    Cy_TCPWM_PWM_SetCompare1BufVal(base, cnt_num,
+        pwm_clock_scale(Cy_TCPWM_PWM_GetCompare1BufVal(base, cnt_num),
+                        reference_period, ratio, period));
+}
+
+/*******************************************************************************
+* Function Name: pwm_clock_assign
+********************************************************************************
+* Summary:
+* Connects another peripheral clock, such as the one of a companion counter,
+* to the divider of the PWM counter.
+*
+* Parameters:
+*  pclk - peripheral clock to connect
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void pwm_clock_assign(en_clk_dst_t pclk)
+{
+    (void)Cy_SysClk_PeriphAssignDivider(pclk, clock_div_type, clock_div_num);
+}
+
+/*******************************************************************************
+* Function Name: pwm_clock_get_hz
+********************************************************************************
+* Summary:
+* Returns the frequency of the counter clock.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  uint32_t - counter clock in Hz
+*
+*******************************************************************************/
+uint32_t pwm_clock_get_hz(void)
+{
+    return clock_hz;
+}
+
+/*******************************************************************************
+* Function Name: pwm_clock_ticks
+********************************************************************************
+* Summary:
+* Converts a tick count of the reference clock to the counter clock, rounded
+* to the nearest tick. Uses a divide and is meant for startup constants.
+*
+* Parameters:
+*  reference_ticks - ticks at PWM_CLOCK_REFERENCE_HZ
+*
+* Return:
+*  uint32_t - ticks at the counter clock
+*
+*******************************************************************************/
+uint32_t pwm_clock_ticks(uint32_t reference_ticks)
+{
+    return pwm_math_rescale(reference_ticks, PWM_CLOCK_REFERENCE_HZ, clock_hz);
+}
@@ -0,0 +1,59 @@
+/*******************************************************************************
+* File Name:   pwm_clock.h
+*
+* Description: Counter clock selection with automatic tick scaling. The
+* period and compare values of the design file and the tick constants of the
+* application are written for PWM_CLOCK_REFERENCE_HZ; at startup they are
+* scaled to the actual counter clock, so a faster clock gives finer edge
+* placement at the same switching frequency.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef PWM_CLOCK_H_
+#define PWM_CLOCK_H_
+
+#include "cy_pdl.h"
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+void pwm_clock_init(TCPWM_Type *base, uint32_t cnt_num);
+void pwm_clock_assign(en_clk_dst_t pclk);
+uint32_t pwm_clock_get_hz(void);
+uint32_t pwm_clock_ticks(uint32_t reference_ticks);
+
+#endif /* PWM_CLOCK_H_ */
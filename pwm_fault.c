@@ -0,0 +1,305 @@
+/*******************************************************************************
+* File Name:   pwm_fault.c
+*
+* Description: Hardware fault shutdown. A fault pin (or a comparator output
+* routed the same way) is connected through the trigger multiplexer to the
+* kill input of the counter. With the stop-on-kill mode of
+* the design file the counter stops within a few clocks of the fault and the
+* outputs go to their disabled state, without any software involvement. As
+* the stopped counter freezes CC0, CC1 and the counter value, a GPIO
+* interrupt latches them afterwards as a diagnostic snapshot, which the main
+* loop reports.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2020-2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include "cy_pdl.h"
+#include "cybsp.h"
+#include "app_config.h"
+#include "pwm_fault.h"
+
+#if (PWM_FAULT_ENABLE)
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+static void pwm_fault_pin_isr(void);
+static bool pwm_fault_is_active(void);
+static void pwm_fault_latch(void);
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+static TCPWM_Type *fault_base; /* Counter protected by the kill input */
+static uint32_t fault_cnt_num;
+static pwm_fault_snapshot_t fault_snapshot; /* Written by the pin handler */
+static volatile bool fault_latched = false; /* Snapshot taken, not cleared */
+static volatile bool fault_reported = true; /* Snapshot read by the app */
+static uint32_t fault_count = 0U;
+
+/*******************************************************************************
+* Function Name: pwm_fault_init
+********************************************************************************
+* Summary:
+* Connects the fault pin to the kill input of the counter and enables the
+* interrupt of the fault pin for the diagnostics. The kill mode of the
+* counter (stop on kill) comes from the design file. The kill input is level
+* sensitive, so the counter cannot run while the fault signal is active, and
+* a fault that is already active is latched here, as it has no edge for the
+* pin interrupt. The counter must only be started if no fault is latched.
+*
+* Parameters:
+*  base - TCPWM block base address
+*  cnt_num - counter number within the block
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void pwm_fault_init(TCPWM_Type *base, uint32_t cnt_num)
+{
+    const cy_stc_sysint_t pin_irq_cfg =
+    {
+        .intrSrc = PWM_FAULT_IRQ,
+        .intrPriority = PWM_FAULT_IRQ_PRIORITY
+    };
+
+    fault_base = base;
+    fault_cnt_num = cnt_num;
+
+    /* The pin feeds the trigger multiplexer through its HSIOM function */
+    Cy_GPIO_Pin_FastInit(PWM_FAULT_PORT, PWM_FAULT_PIN,
+                         PWM_FAULT_ACTIVE_LOW ? CY_GPIO_DM_PULLUP :
+                                                CY_GPIO_DM_PULLDOWN,
+                         PWM_FAULT_ACTIVE_LOW ? 1UL : 0UL, PWM_FAULT_HSIOM);
+
+    /* The fault is passed as a level and kills the counter for as long as
+     * it is active. The route is inverted for an active low fault signal. */
+    if (CY_RSLT_SUCCESS != Cy_TrigMux_Connect(PWM_FAULT_TRIG_IN,
+                                              PWM_FAULT_TRIG_OUT,
+                                              PWM_FAULT_ACTIVE_LOW,
+                                              TRIGGER_TYPE_LEVEL))
+    {
+        CY_ASSERT(0);
+    }
+    Cy_TCPWM_InputTriggerSetup(base, cnt_num, CY_TCPWM_INPUT_TR_STOP_OR_KILL,
+                               CY_TCPWM_INPUT_LEVEL, PWM_FAULT_INPUT);
+
+    /* Pin interrupt for the notification only, the shutdown does not wait
+     * for it. The port interrupt works with any HSIOM function. */
+    Cy_GPIO_SetInterruptEdge(PWM_FAULT_PORT, PWM_FAULT_PIN,
+                             PWM_FAULT_ACTIVE_LOW ? CY_GPIO_INTR_FALLING :
+                                                    CY_GPIO_INTR_RISING);
+    Cy_GPIO_ClearInterrupt(PWM_FAULT_PORT, PWM_FAULT_PIN);
+    Cy_GPIO_SetInterruptMask(PWM_FAULT_PORT, PWM_FAULT_PIN, 1UL);
+    if (CY_SYSINT_SUCCESS != Cy_SysInt_Init(&pin_irq_cfg, pwm_fault_pin_isr))
+    {
+        CY_ASSERT(0);
+    }
+    NVIC_ClearPendingIRQ(pin_irq_cfg.intrSrc);
+    NVIC_EnableIRQ(pin_irq_cfg.intrSrc);
+
+    /* The counter is not started yet; a fault active now is only latched */
+    if (pwm_fault_is_active())
+    {
+        pwm_fault_latch();
+    }
+}
+
+/*******************************************************************************
+* Function Name: pwm_fault_is_latched
+********************************************************************************
+* Summary:
+* Reports whether a fault stopped the counter and was not cleared yet.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  bool - true while the fault is latched
+*
+*******************************************************************************/
+bool pwm_fault_is_latched(void)
+{
+    return fault_latched;
+}
+
+/*******************************************************************************
+* Function Name: pwm_fault_get_snapshot
+********************************************************************************
+* Summary:
+* Returns the snapshot of the latched fault once. The snapshot is not
+* modified until the fault is cleared, so it can be copied without masking
+* interrupts.
+*
+* Parameters:
+*  snapshot - receives the counter state at the fault
+*
+* Return:
+*  bool - true if a fault was latched since the last call
+*
+*******************************************************************************/
+bool pwm_fault_get_snapshot(pwm_fault_snapshot_t *snapshot)
+{
+    if (fault_reported || (!fault_latched))
+    {
+        return false;
+    }
+
+    __DMB();
+    *snapshot = fault_snapshot;
+    fault_reported = true;
+
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: pwm_fault_clear
+********************************************************************************
+* Summary:
+* Restarts the counter after a fault. The counter is only restarted once the
+* fault signal went inactive again. A fault that comes back between the check
+* and the start may leave no edge for the pin interrupt, so the level is
+* checked again after the start and the fault latched anew if it is active.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  bool - false if the fault signal is still or again active
+*
+*******************************************************************************/
+bool pwm_fault_clear(void)
+{
+    if (pwm_fault_is_active())
+    {
+        return false;
+    }
+
+    fault_latched = false;
+    Cy_TCPWM_TriggerStart_Single(fault_base, fault_cnt_num);
+
+    if (pwm_fault_is_active())
+    {
+        Cy_TCPWM_TriggerStopOrKill_Single(fault_base, fault_cnt_num);
+        pwm_fault_latch();
+        return false;
+    }
+
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: pwm_fault_pin_isr
+********************************************************************************
+* Summary:
+* Fault pin interrupt handler. By the time it runs, the kill input has
+* already stopped the counter, so its registers still hold the state at the
+* fault. The first fault is latched until pwm_fault_clear().
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void pwm_fault_pin_isr(void)
+{
+    Cy_GPIO_ClearInterrupt(PWM_FAULT_PORT, PWM_FAULT_PIN);
+
+    pwm_fault_latch();
+}
+
+/*******************************************************************************
+* Function Name: pwm_fault_is_active
+********************************************************************************
+* Summary:
+* Returns the present level of the fault signal.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  bool - true while the fault signal is active
+*
+*******************************************************************************/
+static bool pwm_fault_is_active(void)
+{
+    return (PWM_FAULT_ACTIVE_LOW ? 1UL : 0UL) !=
+           Cy_GPIO_Read(PWM_FAULT_PORT, PWM_FAULT_PIN);
+}
+
+/*******************************************************************************
+* Function Name: pwm_fault_latch
+********************************************************************************
+* Summary:
+* Counts a fault and, unless one is latched already, takes the snapshot of
+* the stopped counter and latches the fault. Runs with interrupts masked, as
+* it is called from the pin interrupt and from the application.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void pwm_fault_latch(void)
+{
+    uint32_t interrupt_state = Cy_SysLib_EnterCriticalSection();
+
+    fault_count++;
+    if (!fault_latched)
+    {
+        fault_snapshot.counter = Cy_TCPWM_PWM_GetCounter(fault_base,
+                                                         fault_cnt_num);
+        fault_snapshot.compare0 = Cy_TCPWM_PWM_GetCompare0Val(fault_base,
+                                                              fault_cnt_num);
+        fault_snapshot.compare1 = Cy_TCPWM_PWM_GetCompare1Val(fault_base,
+                                                              fault_cnt_num);
+        fault_snapshot.status = Cy_TCPWM_PWM_GetStatus(fault_base,
+                                                       fault_cnt_num);
+        fault_snapshot.count = fault_count;
+
+        __DMB();
+        fault_latched = true;
+        fault_reported = false;
+    }
+
+    Cy_SysLib_ExitCriticalSection(interrupt_state);
+}
+
+#endif /* PWM_FAULT_ENABLE */
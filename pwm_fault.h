@@ -0,0 +1,74 @@
+/*******************************************************************************
+* File Name:   pwm_fault.h
+*
+* Description: Hardware fault shutdown. A fault signal (a GPIO, or a
+* comparator output routed the same way) is connected through the trigger
+* multiplexer to the kill input of the counter. With the stop-on-kill mode of
+* the design file the counter stops within a few clocks of the fault and the
+* outputs go to their disabled state, without any software involvement. As
+* the stopped counter freezes CC0, CC1 and the counter value, a GPIO
+* interrupt latches them afterwards as a diagnostic snapshot, which the main
+* loop reports.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2020-2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef PWM_FAULT_H_
+#define PWM_FAULT_H_
+
+#include "cy_pdl.h"
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+/* State of the counter after the kill input stopped it */
+typedef struct
+{
+    uint32_t counter;  /* Counter value at the stop */
+    uint32_t compare0; /* Active CC0 value */
+    uint32_t compare1; /* Active CC1 value */
+    uint32_t status;   /* Counter status register, e.g. count direction */
+    uint32_t count;    /* Number of faults since startup, including this */
+} pwm_fault_snapshot_t;
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+void pwm_fault_init(TCPWM_Type *base, uint32_t cnt_num);
+bool pwm_fault_is_latched(void);
+bool pwm_fault_get_snapshot(pwm_fault_snapshot_t *snapshot);
+bool pwm_fault_clear(void);
+
+#endif /* PWM_FAULT_H_ */
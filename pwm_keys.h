@@ -0,0 +1,110 @@
+/*******************************************************************************
+* File Name:   pwm_keys.h
+*
+* Description: Waveform change of the single-key commands. Moves the compare
+* pair by one step for each of the keys 'w', 's', 'a' and 'd' and keeps it
+* within the period. Free of device access, so it also builds for the host
+* (see pwm_port.h).
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef PWM_KEYS_H_
+#define PWM_KEYS_H_
+
+#include "pwm_port.h"
+#include "pwm_math.h"
+
+/*******************************************************************************
+* Function Name: pwm_keys_apply
+********************************************************************************
+* Summary:
+* Applies a waveform key to a compare pair. 's' and 'w' move both compare
+* values in the same direction to increase or decrease the duty cycle, 'a'
+* and 'd' move them apart to shift the pulse left or right. The result is
+* limited to 0..period.
+*
+* Parameters:
+*  key - key pressed
+*  step - change of each compare value, in counter ticks
+*  period - period in counter ticks
+*  compare0 - CC0 value, updated for a waveform key
+*  compare1 - CC1 value, updated for a waveform key
+*
+* Return:
+*  bool - true if the key is a waveform key, false if it was not handled
+*
+*******************************************************************************/
+__STATIC_INLINE bool pwm_keys_apply(char key, int32_t step, int32_t period,
+                                    int32_t *compare0, int32_t *compare1)
+{
+    int32_t delta0;
+    int32_t delta1;
+
+    switch (key)
+    {
+        /* Increase duty cycle */
+        case 's':
+            delta0 = step;
+            delta1 = step;
+            break;
+        /* Decrease duty cycle */
+        case 'w':
+            delta0 = -step;
+            delta1 = -step;
+            break;
+        /* Shift waveform to left */
+        case 'a':
+            delta0 = -step;
+            delta1 = step;
+            break;
+        /* Shift waveform to right */
+        case 'd':
+            delta0 = step;
+            delta1 = -step;
+            break;
+        default:
+            return false;
+    }
+
+    /* Keep both compare values within the period */
+    *compare0 = pwm_math_clamp(*compare0 + delta0, period);
+    *compare1 = pwm_math_clamp(*compare1 + delta1, period);
+
+    return true;
+}
+
+#endif /* PWM_KEYS_H_ */
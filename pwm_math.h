@@ -0,0 +1,260 @@
+/*******************************************************************************
+* File Name:   pwm_math.h
+*
+* Description: Fixed-point waveform math for the center-aligned asymmetric
+* CC0/CC1 PWM. Converts duty cycle and phase offset in Q15 to a compare pair
+* and back using only multiplies, shifts and branch-free saturation, so it
+* can run in an interrupt handler every PWM cycle.
+*
+* The counter counts up from 0 to the period P and back down. The output goes
+* high at the CC0 match while counting up and low at the CC1 match while
+* counting down, so for a pulse of high time H = duty * 2P centered at shift
+* S = phase * P ticks (positive to the right):
+*   CC0 = P - H/2 + S,  CC1 = P - H/2 - S
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2020-2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef PWM_MATH_H_
+#define PWM_MATH_H_
+
+#include "pwm_port.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define PWM_MATH_Q15_ONE        (32768L) /* 1.0 in Q15 */
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+typedef struct
+{
+    int32_t period;         /* Period0 in counter ticks */
+    uint32_t period_recip;  /* floor(2^32 / period), used instead of divides */
+} pwm_math_t;
+
+/*******************************************************************************
+* Function Name: pwm_math_init
+********************************************************************************
+* Summary:
+* Stores the period and precomputes its reciprocal. This is the only divide
+* of the module and is meant to run once, outside of the time-critical path.
+*
+* Parameters:
+*  math - conversion context
+*  period - Period0 in counter ticks, at least 2
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+__STATIC_INLINE void pwm_math_init(pwm_math_t *math, uint32_t period)
+{
+    CY_ASSERT(period >= 2U);
+
+    math->period = (int32_t)period;
+    math->period_recip = (uint32_t)(0x100000000ULL / period);
+}
+
+/*******************************************************************************
+* Function Name: pwm_math_clamp
+********************************************************************************
+* Summary:
+* Limits a value to the range 0 to limit without branches.
+*
+* Parameters:
+*  value - value to limit
+*  limit - upper bound, not negative
+*
+* Return:
+*  int32_t - value within range
+*
+*******************************************************************************/
+__STATIC_FORCEINLINE int32_t pwm_math_clamp(int32_t value, int32_t limit)
+{
+    int32_t excess;
+
+    /* max(value, 0): the sign mask clears negative values */
+    value &= ~(value >> 31);
+
+    /* min(value, limit): only a negative excess is kept */
+    excess = value - limit;
+    return limit + (excess & (excess >> 31));
+}
+
+/*******************************************************************************
+* Function Name: pwm_math_to_compare
+********************************************************************************
+* Summary:
+* Converts duty cycle and phase offset to a compare pair. Both inputs are
+* saturated, and each compare value is limited to 0..period, so the pulse is
+* clipped rather than wrapped around when it does not fit into the period.
+*
+* Parameters:
+*  math - conversion context
+*  duty - high time as Q15 fraction of the PWM cycle, 0 to PWM_MATH_Q15_ONE
+*  phase - shift of the pulse center as Q15 fraction of the period, -1.0 to
+*          1.0, positive values shift to the right
+*  compare0 - resulting CC0 value
+*  compare1 - resulting CC1 value
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+__STATIC_FORCEINLINE void pwm_math_to_compare(const pwm_math_t *math,
+                                              int32_t duty, int32_t phase,
+                                              uint32_t *compare0,
+                                              uint32_t *compare1)
+{
+    int32_t half_high;
+    int32_t shift;
+    int32_t base;
+
+    duty = pwm_math_clamp(duty, PWM_MATH_Q15_ONE);
+    phase = pwm_math_clamp(phase + PWM_MATH_Q15_ONE, 2 * PWM_MATH_Q15_ONE) -
+            PWM_MATH_Q15_ONE;
+
+    /* H/2 = duty * P, S = phase * P */
+    half_high = (duty * math->period) >> 15;
+    shift = (phase * math->period) >> 15;
+    base = math->period - half_high;
+
+    *compare0 = (uint32_t)pwm_math_clamp(base + shift, math->period);
+    *compare1 = (uint32_t)pwm_math_clamp(base - shift, math->period);
+}
+
+/*******************************************************************************
+* Function Name: pwm_math_duty
+********************************************************************************
+* Summary:
+* Returns the duty cycle of a compare pair.
+*
+* Parameters:
+*  math - conversion context
+*  compare0 - CC0 value
+*  compare1 - CC1 value
+*
+* Return:
+*  int32_t - duty cycle in Q15
+*
+*******************************************************************************/
+__STATIC_FORCEINLINE int32_t pwm_math_duty(const pwm_math_t *math,
+                                           uint32_t compare0,
+                                           uint32_t compare1)
+{
+    /* duty = H / 2P = (2P - CC0 - CC1) * (2^32 / P) / 2^18 in Q15 */
+    int32_t high = (2 * math->period) - (int32_t)compare0 - (int32_t)compare1;
+
+    return (int32_t)(((int64_t)high * math->period_recip) >> 18);
+}
+
+/*******************************************************************************
+* Function Name: pwm_math_phase
+********************************************************************************
+* Summary:
+* Returns the phase offset of a compare pair.
+*
+* Parameters:
+*  math - conversion context
+*  compare0 - CC0 value
+*  compare1 - CC1 value
+*
+* Return:
+*  int32_t - shift of the pulse center in Q15 fraction of the period
+*
+*******************************************************************************/
+__STATIC_FORCEINLINE int32_t pwm_math_phase(const pwm_math_t *math,
+                                            uint32_t compare0,
+                                            uint32_t compare1)
+{
+    /* phase = S / P = (CC0 - CC1) / 2P in Q15 */
+    int32_t difference = (int32_t)compare0 - (int32_t)compare1;
+
+    return (int32_t)(((int64_t)difference * math->period_recip) >> 18);
+}
+
+/*******************************************************************************
+* Function Name: pwm_math_rescale
+********************************************************************************
+* Summary:
+* Scales a compare value from one period to another, rounded to the nearest
+* tick, so duty cycle and phase stay the same. Uses a divide and is meant for
+* occasional period changes, not for the per-cycle path.
+*
+* Parameters:
+*  value - compare value for the old period
+*  old_period - current period
+*  new_period - target period
+*
+* Return:
+*  uint32_t - compare value for the new period
+*
+*******************************************************************************/
+__STATIC_INLINE uint32_t pwm_math_rescale(uint32_t value, uint32_t old_period,
+                                          uint32_t new_period)
+{
+    return (uint32_t)((((uint64_t)value * new_period) + (old_period / 2U)) /
+                      old_period);
+}
+
+/*******************************************************************************
+* Function Name: pwm_math_slew
+********************************************************************************
+* Summary:
+* Moves a Q16.16 compare position toward its target by at most one step.
+*
+* Parameters:
+*  position - current position
+*  target - target position
+*  step - largest change
+*
+* Return:
+*  uint32_t - new position, equal to target once it is within one step
+*
+*******************************************************************************/
+__STATIC_FORCEINLINE uint32_t pwm_math_slew(uint32_t position, uint32_t target,
+                                            uint32_t step)
+{
+    if (target > position)
+    {
+        return ((target - position) > step) ? (position + step) : target;
+    }
+
+    return ((position - target) > step) ? (position - step) : target;
+}
+
+#endif /* PWM_MATH_H_ */
@@ -0,0 +1,78 @@
+/*******************************************************************************
+* File Name:   pwm_port.h
+*
+* Description: Platform shim of the waveform computation. The fixed-point
+* kernels (pwm_math.h, pwm_keys.h, pwm_svpwm.c) only need the compiler
+* macros and the assertion of the PDL. Built with PWM_PORT_HOST defined,
+* they take these from the C standard library instead and compile for a
+* desktop host, where they can be exercised and benchmarked without the
+* device. Everything else stays on the PDL. The shim also selects where the
+* functions of the terminal count path are placed (PWM_RAMFUNC_BEGIN).
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef PWM_PORT_H_
+#define PWM_PORT_H_
+
+#if defined(PWM_PORT_HOST)
+#include <assert.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define __STATIC_INLINE         static inline
+#define __STATIC_FORCEINLINE    static inline
+#define CY_ASSERT(x)            assert(x)
+#else
+#include "cy_pdl.h"
+#include "app_config.h"
+#endif
+
+/* Placement of the functions on the terminal count path: the PDL section of
+ * code copied to SRAM at startup, or the default flash placement */
+#if !defined(PWM_PORT_HOST) && (PWM_RAMFUNC_ENABLE)
+#define PWM_RAMFUNC_BEGIN       CY_SECTION_RAMFUNC_BEGIN
+#define PWM_RAMFUNC_END         CY_SECTION_RAMFUNC_END
+#else
+#define PWM_RAMFUNC_BEGIN
+#define PWM_RAMFUNC_END
+#endif
+
+#endif /* PWM_PORT_H_ */
@@ -0,0 +1,129 @@
+/*******************************************************************************
+* File Name:   pwm_ramp.h
+*
+* Description: Per-period step of the compare ramp of the update engine. The
+* compare positions are Q16.16 so that slew rates below one tick per period
+* are possible. Free of device access, so it also builds for the host (see
+* pwm_port.h).
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef PWM_RAMP_H_
+#define PWM_RAMP_H_
+
+#include "pwm_port.h"
+#include "pwm_math.h"
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+typedef struct
+{
+    uint32_t position0; /* CC0 position in Q16.16 ticks */
+    uint32_t position1; /* CC1 position in Q16.16 ticks */
+} pwm_ramp_t;
+
+/*******************************************************************************
+* Function Name: pwm_ramp_init
+********************************************************************************
+* Summary:
+* Places the ramp on a compare pair.
+*
+* Parameters:
+*  ramp - ramp state
+*  compare0 - CC0 value
+*  compare1 - CC1 value
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+__STATIC_INLINE void pwm_ramp_init(pwm_ramp_t *ramp, uint32_t compare0,
+                                   uint32_t compare1)
+{
+    ramp->position0 = compare0 << 16U;
+    ramp->position1 = compare1 << 16U;
+}
+
+/*******************************************************************************
+* Function Name: pwm_ramp_step
+********************************************************************************
+* Summary:
+* Moves the ramp one period toward a target pair, by at most the slew rate
+* per compare value, and returns the pair to write. With a slew rate of 0, or
+* when the period changes, the ramp jumps to the target, as a ramp across
+* two periods would mix scales.
+*
+* Parameters:
+*  ramp - ramp state
+*  target0 - target CC0 value
+*  target1 - target CC1 value
+*  slew - largest change per period in Q16.16 ticks, 0 to jump
+*  jump - true to jump to the target regardless of the slew rate
+*  compare0 - CC0 value to write
+*  compare1 - CC1 value to write
+*
+* Return:
+*  bool - true while the ramp has not reached the target
+*
+*******************************************************************************/
+__STATIC_FORCEINLINE bool pwm_ramp_step(pwm_ramp_t *ramp, uint32_t target0,
+                                        uint32_t target1, uint32_t slew,
+                                        bool jump, uint32_t *compare0,
+                                        uint32_t *compare1)
+{
+    if (jump || (0U == slew))
+    {
+        ramp->position0 = target0 << 16U;
+        ramp->position1 = target1 << 16U;
+    }
+    else
+    {
+        ramp->position0 = pwm_math_slew(ramp->position0, target0 << 16U,
+                                        slew);
+        ramp->position1 = pwm_math_slew(ramp->position1, target1 << 16U,
+                                        slew);
+    }
+
+    *compare0 = ramp->position0 >> 16U;
+    *compare1 = ramp->position1 >> 16U;
+
+    return (ramp->position0 != (target0 << 16U)) ||
+           (ramp->position1 != (target1 << 16U));
+}
+
+#endif /* PWM_RAMP_H_ */
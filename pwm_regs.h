@@ -0,0 +1,90 @@
+/*******************************************************************************
+* File Name:   pwm_regs.h
+*
+* Description: Compile-time register access for counters configured in the
+* design file. The Device Configurator generates the block base and the
+* counter number of every counter as constants (for example
+* TCPWM0_GRP1_CNT0_HW and TCPWM0_GRP1_CNT0_NUM); these macros turn them into
+* constant register addresses, so a compare update is two stores and one
+* trigger write instead of three PDL calls that compute the addresses at run
+* time. Needs TCPWM v2, the only version with a second compare register.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2020-2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef PWM_REGS_H_
+#define PWM_REGS_H_
+
+#include "cy_pdl.h"
+
+#if (CY_IP_MXTCPWM_VERSION == 1U)
+#error "pwm_regs.h needs TCPWM v2"
+#endif
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+/* Registers of counter num in block hw. With constant arguments every macro
+ * reduces to a fixed address. */
+#define PWM_REGS_CC0(hw, num) \
+            TCPWM_GRP_CNT_CC0((hw), TCPWM_GRP_CNT_GET_GRP(num), (num))
+#define PWM_REGS_CC1(hw, num) \
+            TCPWM_GRP_CNT_CC1((hw), TCPWM_GRP_CNT_GET_GRP(num), (num))
+#define PWM_REGS_CC0_BUFF(hw, num) \
+            TCPWM_GRP_CNT_CC0_BUFF((hw), TCPWM_GRP_CNT_GET_GRP(num), (num))
+#define PWM_REGS_CC1_BUFF(hw, num) \
+            TCPWM_GRP_CNT_CC1_BUFF((hw), TCPWM_GRP_CNT_GET_GRP(num), (num))
+#define PWM_REGS_PERIOD_BUFF(hw, num) \
+            TCPWM_GRP_CNT_PERIOD_BUFF((hw), TCPWM_GRP_CNT_GET_GRP(num), (num))
+#define PWM_REGS_TR_CMD(hw, num) \
+            TCPWM_GRP_CNT_TR_CMD((hw), TCPWM_GRP_CNT_GET_GRP(num), (num))
+#define PWM_REGS_INTR(hw, num) \
+            TCPWM_GRP_CNT_INTR((hw), TCPWM_GRP_CNT_GET_GRP(num), (num))
+
+/* Requests a swap at the next terminal count, as
+ * Cy_TCPWM_TriggerCaptureOrSwap_Single() */
+#define PWM_REGS_TRIGGER_SWAP(hw, num) \
+            (PWM_REGS_TR_CMD((hw), (num)) = TCPWM_GRP_CNT_V2_TR_CMD_CAPTURE0_Msk)
+
+/* Writes a compare pair to the buffer registers and requests the swap */
+#define PWM_REGS_UPDATE(hw, num, compare0, compare1) \
+            do \
+            { \
+                PWM_REGS_CC0_BUFF((hw), (num)) = (compare0); \
+                PWM_REGS_CC1_BUFF((hw), (num)) = (compare1); \
+                PWM_REGS_TRIGGER_SWAP((hw), (num)); \
+            } while (0)
+
+#endif /* PWM_REGS_H_ */
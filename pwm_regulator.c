@@ -0,0 +1,251 @@
+/*******************************************************************************
+* File Name:   pwm_regulator.c
+*
+* Description: Closed-loop duty regulation. A fixed-point PI controller runs
+* in the terminal count ISR of the update engine. The SAR scan started at the
+* peak of the period has finished by the terminal count, so every period the
+* controller reads the result register directly, without waiting for the
+* DataWire half buffer. The duty cycle is computed in Q15, and the update
+* engine converts it into a centered compare pair and writes it through the
+* buffered swap.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include "cy_pdl.h"
+#include "pwm_port.h"
+#include "current_sense.h"
+#include "pwm_math.h"
+#include "pwm_regulator.h"
+
+#if (PWM_REGULATOR_ENABLE)
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+/* The integrator holds the duty cycle in Q15 with 8 more fraction bits,
+ * the resolution of the Q8.8 gains */
+#define REGULATOR_INTEGRAL_SHIFT    (8U)
+#define REGULATOR_INTEGRAL_MAX      (PWM_REGULATOR_DUTY_MAX << \
+                                     REGULATOR_INTEGRAL_SHIFT)
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+/* Written by the main loop, read once per period by the ISR. A gain pair
+ * changed between two periods is applied one gain at a time, which is
+ * harmless as both only scale the next correction. */
+static volatile int32_t regulator_kp = (int32_t)PWM_REGULATOR_KP;
+static volatile int32_t regulator_ki = (int32_t)PWM_REGULATOR_KI;
+static volatile int32_t regulator_setpoint = 0;
+static volatile bool regulator_running = false;
+
+/* Owned by the ISR while the regulator runs */
+static int32_t regulator_integral = 0;
+static volatile uint32_t regulator_measurement = 0U;
+static volatile int32_t regulator_duty = 0;
+
+/*******************************************************************************
+* Function Name: pwm_regulator_set_gains
+********************************************************************************
+* Summary:
+* Sets the proportional and integral gains. Both are Q8.8 fractions of the
+* Q15 duty cycle per ADC count of error; the integral gain applies once per
+* PWM period. A running regulator uses them from the next period on.
+*
+* Parameters:
+*  kp - proportional gain, Q8.8
+*  ki - integral gain per period, Q8.8
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void pwm_regulator_set_gains(uint32_t kp, uint32_t ki)
+{
+    CY_ASSERT((kp <= 0xFFFFU) && (ki <= 0xFFFFU));
+
+    regulator_kp = (int32_t)kp;
+    regulator_ki = (int32_t)ki;
+}
+
+/*******************************************************************************
+* Function Name: pwm_regulator_start
+********************************************************************************
+* Summary:
+* Sets the setpoint and starts the regulator if it is stopped. On start the
+* integrator is preset to the given duty cycle, so the output continues from
+* the current waveform without a step. A running regulator keeps its state
+* and only follows the new setpoint.
+*
+* Parameters:
+*  setpoint - target of the measurement in ADC counts
+*  duty - duty cycle of the current waveform in Q15
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void pwm_regulator_start(uint32_t setpoint, int32_t duty)
+{
+    CY_ASSERT(setpoint <= PWM_REGULATOR_MEASUREMENT_MAX);
+
+    regulator_setpoint = (int32_t)setpoint;
+    if (!regulator_running)
+    {
+        duty = pwm_math_clamp(duty, PWM_REGULATOR_DUTY_MAX);
+        regulator_integral = duty << REGULATOR_INTEGRAL_SHIFT;
+        regulator_duty = duty;
+        __DMB();
+        regulator_running = true;
+    }
+}
+
+/*******************************************************************************
+* Function Name: pwm_regulator_stop
+********************************************************************************
+* Summary:
+* Stops the regulator. On the next terminal count the update engine returns
+* to the last values staged by the application.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void pwm_regulator_stop(void)
+{
+    regulator_running = false;
+}
+
+/*******************************************************************************
+* Function Name: pwm_regulator_is_running
+********************************************************************************
+* Summary:
+* Returns whether the regulator controls the waveform.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  bool - true while the regulator runs
+*
+*******************************************************************************/
+PWM_RAMFUNC_BEGIN
+bool pwm_regulator_is_running(void)
+{
+    return regulator_running;
+}
+PWM_RAMFUNC_END
+
+/*******************************************************************************
+* Function Name: pwm_regulator_step
+********************************************************************************
+* Summary:
+* Runs one period of the PI controller on the newest measurement. Called from
+* the terminal count ISR while the regulator runs. The integrator stops at
+* the duty limits, so it does not wind up while the output saturates.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  int32_t - duty cycle for the next period in Q15, 0 to
+*  PWM_REGULATOR_DUTY_MAX
+*
+*******************************************************************************/
+PWM_RAMFUNC_BEGIN
+int32_t pwm_regulator_step(void)
+{
+    uint32_t measurement = current_sense_read(PWM_REGULATOR_CHANNEL);
+    int32_t error = regulator_setpoint - (int32_t)measurement;
+    int32_t proportional;
+    int32_t duty;
+
+    /* 16-bit gains and 12-bit errors cannot overflow 32 bits */
+    regulator_integral = pwm_math_clamp(regulator_integral +
+                                        (regulator_ki * error),
+                                        REGULATOR_INTEGRAL_MAX);
+    proportional = (regulator_kp * error) >> REGULATOR_INTEGRAL_SHIFT;
+    duty = pwm_math_clamp((regulator_integral >> REGULATOR_INTEGRAL_SHIFT) +
+                          proportional, PWM_REGULATOR_DUTY_MAX);
+
+    regulator_measurement = measurement;
+    regulator_duty = duty;
+
+    return duty;
+}
+PWM_RAMFUNC_END
+
+/*******************************************************************************
+* Function Name: pwm_regulator_get_measurement
+********************************************************************************
+* Summary:
+* Returns the measurement used in the last period of the regulator.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  uint32_t - SAR result in ADC counts
+*
+*******************************************************************************/
+uint32_t pwm_regulator_get_measurement(void)
+{
+    return regulator_measurement;
+}
+
+/*******************************************************************************
+* Function Name: pwm_regulator_get_duty
+********************************************************************************
+* Summary:
+* Returns the duty cycle computed in the last period of the regulator.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  int32_t - duty cycle in Q15
+*
+*******************************************************************************/
+int32_t pwm_regulator_get_duty(void)
+{
+    return regulator_duty;
+}
+
+#endif /* PWM_REGULATOR_ENABLE */
@@ -0,0 +1,64 @@
+/*******************************************************************************
+* File Name:   pwm_regulator.h
+*
+* Description: Closed-loop duty regulation. A fixed-point PI controller runs
+* in the terminal count ISR of the update engine: every PWM period it reads
+* the newest SAR result of the PWM-synchronized current sampling, computes
+* the duty cycle that drives the measurement to the setpoint, and the update
+* engine writes the resulting compare pair for the next period. Gains and
+* setpoint are set through the command protocol.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef PWM_REGULATOR_H_
+#define PWM_REGULATOR_H_
+
+#include "cy_pdl.h"
+#include "app_config.h"
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+void pwm_regulator_set_gains(uint32_t kp, uint32_t ki);
+void pwm_regulator_start(uint32_t setpoint, int32_t duty);
+void pwm_regulator_stop(void);
+bool pwm_regulator_is_running(void);
+int32_t pwm_regulator_step(void);
+uint32_t pwm_regulator_get_measurement(void);
+int32_t pwm_regulator_get_duty(void);
+
+#endif /* PWM_REGULATOR_H_ */
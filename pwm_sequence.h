@@ -0,0 +1,152 @@
+/*******************************************************************************
+* File Name:   pwm_sequence.h
+*
+* Description: Per-period step of the sequencer of the update engine. Counts
+* down the dwell of the current step and moves through the table and its
+* passes. Free of device access, so it also builds for the host (see
+* pwm_port.h).
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef PWM_SEQUENCE_H_
+#define PWM_SEQUENCE_H_
+
+#include "pwm_port.h"
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+/* One step of a sequence */
+typedef struct
+{
+    uint16_t compare0;  /* CC0 value */
+    uint16_t compare1;  /* CC1 value */
+    uint16_t period;    /* Period in counter ticks, 0 to keep the current */
+    uint16_t dwell;     /* Number of periods the step lasts, at least 1 */
+} pwm_sequence_step_t;
+
+typedef struct
+{
+    const pwm_sequence_step_t *steps; /* Table being played */
+    uint32_t count;     /* Number of steps in the table */
+    uint32_t repeat;    /* Passes to play, 0 for endless */
+    uint32_t index;     /* Step played next */
+    uint32_t pass;      /* Passes completed */
+    uint32_t dwell;     /* Periods left of the current step */
+} pwm_sequence_t;
+
+typedef enum
+{
+    PWM_SEQUENCE_HOLD,  /* The current step continues */
+    PWM_SEQUENCE_STEP,  /* A new step starts */
+    PWM_SEQUENCE_END    /* The sequence ended or was stopped */
+} pwm_sequence_event_t;
+
+/*******************************************************************************
+* Function Name: pwm_sequence_start
+********************************************************************************
+* Summary:
+* Prepares a sequence so that its first step starts on the next call of
+* pwm_sequence_advance().
+*
+* Parameters:
+*  sequence - sequencer state
+*  steps - table of steps, each with a dwell of at least 1
+*  count - number of steps in the table, at least 1
+*  repeat - number of passes through the table, 0 to repeat until stopped
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+__STATIC_INLINE void pwm_sequence_start(pwm_sequence_t *sequence,
+                                        const pwm_sequence_step_t *steps,
+                                        uint32_t count, uint32_t repeat)
+{
+    sequence->steps = steps;
+    sequence->count = count;
+    sequence->repeat = repeat;
+    sequence->index = 0U;
+    sequence->pass = 0U;
+    sequence->dwell = 1U;
+}
+
+/*******************************************************************************
+* Function Name: pwm_sequence_advance
+********************************************************************************
+* Summary:
+* Runs the sequencer for one period. Once the dwell of the current step has
+* expired, the next step starts; after the last step of the last pass, or on
+* a stop request, the sequence ends.
+*
+* Parameters:
+*  sequence - sequencer state
+*  stop - true to end the sequence now
+*  step - receives the step that starts, for PWM_SEQUENCE_STEP
+*
+* Return:
+*  pwm_sequence_event_t - what happens in this period
+*
+*******************************************************************************/
+__STATIC_FORCEINLINE pwm_sequence_event_t pwm_sequence_advance(
+    pwm_sequence_t *sequence, bool stop, const pwm_sequence_step_t **step)
+{
+    if (!stop && (0U != --sequence->dwell))
+    {
+        return PWM_SEQUENCE_HOLD;
+    }
+
+    if (!stop && (sequence->index == sequence->count))
+    {
+        sequence->index = 0U;
+        sequence->pass++;
+        stop = (0U != sequence->repeat) &&
+               (sequence->pass == sequence->repeat);
+    }
+
+    if (stop)
+    {
+        return PWM_SEQUENCE_END;
+    }
+
+    *step = &sequence->steps[sequence->index++];
+    sequence->dwell = (*step)->dwell;
+
+    return PWM_SEQUENCE_STEP;
+}
+
+#endif /* PWM_SEQUENCE_H_ */
@@ -0,0 +1,411 @@
+/*******************************************************************************
+* File Name:   pwm_stream.c
+*
+* Description: Zero-CPU compare streaming. A DataWire channel triggered by
+* the terminal count output (tr_out0) of the counter copies one CC0/CC1 pair
+* per PWM period from a RAM table into the compare buffer registers. Its
+* completion trigger drives the swap input of the counter, so the new pair is
+* swapped in at the following terminal count without any CPU involvement.
+* The table is played as two ping-pong halves; a callback reports each half
+* that completed so the application can refill it while the other half plays.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2020-2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include "cy_pdl.h"
+#include "cybsp.h"
+#include "app_config.h"
+#include "pwm_stream.h"
+#include "pwm_regs.h"
+#include "pwm_update.h"
+
+#if (PWM_STREAM_ENABLE)
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define PAIR_WORDS              (2UL) /* Words copied per trigger */
+#define CC_BUFF_STRIDE_WORDS    (2UL) /* Distance CC0_BUFF to CC1_BUFF */
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+static void pwm_stream_dma_isr(void);
+static void pwm_stream_descriptor_init(uint32_t half,
+                                       const pwm_stream_pair_t *src,
+                                       uint32_t rows, bool loop);
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+static volatile uint32_t *cc0_buff_reg; /* DMA destination */
+static cy_stc_dma_descriptor_t stream_descriptor[2]; /* Ping-pong halves */
+static pwm_stream_callback_t stream_callback = NULL;
+static void *stream_callback_arg = NULL;
+static volatile uint32_t playing_half = 0U; /* Half the DMA is working on */
+static volatile bool stream_active = false;
+static bool stream_loop = false; /* Second half chains to the first */
+
+/* Table requested by pwm_stream_swap(), applied half by half */
+static const pwm_stream_pair_t *volatile pending_table = NULL;
+static volatile uint32_t pending_halves = 0U;
+static uint32_t half_rows = 0U;
+
+/*******************************************************************************
+* Function Name: pwm_stream_init
+********************************************************************************
+* Summary:
+* Routes the counter terminal count to the DataWire channel and the DataWire
+* completion back to the swap input of the counter, and sets up the DMA
+* interrupt. The counter must already be initialized.
+*
+* Parameters:
+*  base - TCPWM block base address
+*  cnt_num - counter number within the block
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void pwm_stream_init(TCPWM_Type *base, uint32_t cnt_num)
+{
+    const cy_stc_sysint_t dma_irq_cfg =
+    {
+        .intrSrc = PWM_STREAM_DW_IRQ,
+        .intrPriority = PWM_STREAM_DW_IRQ_PRIORITY
+    };
+
+    cc0_buff_reg = &PWM_REGS_CC0_BUFF(base, cnt_num);
+
+    /* TC -> DMA request, DMA done -> counter swap */
+    if ((CY_RSLT_SUCCESS != Cy_TrigMux_Connect(PWM_STREAM_TC_TRIG_IN,
+                                               PWM_STREAM_TC_TRIG_OUT, false,
+                                               TRIGGER_TYPE_EDGE)) ||
+        (CY_RSLT_SUCCESS != Cy_TrigMux_Connect(PWM_STREAM_SWAP_TRIG_IN,
+                                               PWM_STREAM_SWAP_TRIG_OUT, false,
+                                               TRIGGER_TYPE_EDGE)))
+    {
+        CY_ASSERT(0);
+    }
+    Cy_TCPWM_InputTriggerSetup(base, cnt_num, CY_TCPWM_INPUT_TR_CAPTURE0,
+                               CY_TCPWM_INPUT_RISINGEDGE,
+                               PWM_STREAM_SWAP_INPUT);
+
+    if (CY_SYSINT_SUCCESS != Cy_SysInt_Init(&dma_irq_cfg, pwm_stream_dma_isr))
+    {
+        CY_ASSERT(0);
+    }
+    NVIC_EnableIRQ(dma_irq_cfg.intrSrc);
+
+    Cy_DMA_Enable(PWM_STREAM_DW);
+}
+
+/*******************************************************************************
+* Function Name: pwm_stream_load
+********************************************************************************
+* Summary:
+* Prepares the DMA descriptors for a table. The first half plays from
+* table[0] and the second half from table[length / 2]. The stream must be
+* stopped.
+*
+* Parameters:
+*  table - compare pairs, must stay valid while the stream plays
+*  length - number of pairs, even and at least 2
+*  loop - true to wrap around to the first half after the second half
+*
+* Return:
+*  bool - false if the stream is active or the length is invalid
+*
+*******************************************************************************/
+bool pwm_stream_load(const pwm_stream_pair_t *table, uint32_t length,
+                     bool loop)
+{
+    cy_stc_dma_channel_config_t channel_config =
+    {
+        .descriptor = &stream_descriptor[0],
+        .preemptable = false,
+        .priority = 0U,
+        .enable = false,
+        .bufferable = false
+    };
+
+    if (stream_active || (NULL == table) || (length < 2U) ||
+        (0U != (length & 1U)) || ((length / 2U) > 256U))
+    {
+        return false;
+    }
+
+    half_rows = length / 2U;
+    stream_loop = loop;
+    pwm_stream_descriptor_init(0U, &table[0], half_rows, true);
+    pwm_stream_descriptor_init(1U, &table[half_rows], half_rows, loop);
+
+    if (CY_DMA_SUCCESS != Cy_DMA_Channel_Init(PWM_STREAM_DW,
+                                              PWM_STREAM_DW_CHANNEL,
+                                              &channel_config))
+    {
+        return false;
+    }
+    Cy_DMA_Channel_SetInterruptMask(PWM_STREAM_DW, PWM_STREAM_DW_CHANNEL,
+                                    CY_DMA_INTR_MASK);
+
+    playing_half = 0U;
+    pending_table = NULL;
+    pending_halves = 0U;
+
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: pwm_stream_swap
+********************************************************************************
+* Summary:
+* Switches a playing stream over to another table of the same length. Each
+* half is re-pointed right after it finished playing, so the output goes on
+* seamlessly from the end of the current table to the start of the new one.
+*
+* Parameters:
+*  table - new compare pairs
+*  length - number of pairs, must be equal to the loaded table
+*
+* Return:
+*  bool - false if the length differs or a swap is still in progress
+*
+*******************************************************************************/
+bool pwm_stream_swap(const pwm_stream_pair_t *table, uint32_t length)
+{
+    if ((NULL == table) || (length != (half_rows * 2U)) ||
+        (0U != pending_halves))
+    {
+        return false;
+    }
+
+    pending_table = table;
+    __DMB();
+    pending_halves = 2U;
+
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: pwm_stream_register_callback
+********************************************************************************
+* Summary:
+* Registers the function called each time a half of the table completed.
+*
+* Parameters:
+*  callback - function to call, NULL to disable
+*  callback_arg - argument passed to the callback
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void pwm_stream_register_callback(pwm_stream_callback_t callback,
+                                  void *callback_arg)
+{
+    stream_callback = NULL;
+    __DMB();
+    stream_callback_arg = callback_arg;
+    __DMB();
+    stream_callback = callback;
+}
+
+/*******************************************************************************
+* Function Name: pwm_stream_start
+********************************************************************************
+* Summary:
+* Enables the DataWire channel. The first pair is transferred on the next
+* terminal count. The terminal count ISR of pwm_update.c is suspended until
+* the stream stops, so the two never write the buffers in the same period.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void pwm_stream_start(void)
+{
+    /* The terminal count ISR would write the same buffers */
+    pwm_update_suspend();
+    stream_active = true;
+    Cy_DMA_Channel_Enable(PWM_STREAM_DW, PWM_STREAM_DW_CHANNEL);
+}
+
+/*******************************************************************************
+* Function Name: pwm_stream_stop
+********************************************************************************
+* Summary:
+* Disables the DataWire channel and resumes the terminal count ISR, which
+* ramps from the last transferred pair to the last staged values.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void pwm_stream_stop(void)
+{
+    uint32_t saved_intr = Cy_SysLib_EnterCriticalSection();
+    bool was_active = stream_active;
+
+    Cy_DMA_Channel_Disable(PWM_STREAM_DW, PWM_STREAM_DW_CHANNEL);
+    stream_active = false;
+    Cy_SysLib_ExitCriticalSection(saved_intr);
+
+    /* The DMA ISR resumes a stream that already ended by itself */
+    if (was_active)
+    {
+        pwm_update_resume();
+    }
+}
+
+/*******************************************************************************
+* Function Name: pwm_stream_is_active
+********************************************************************************
+* Summary:
+* Reports whether a table is playing. A stream loaded without looping stops
+* by itself after the second half.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  bool - true while the DMA channel is running
+*
+*******************************************************************************/
+bool pwm_stream_is_active(void)
+{
+    return stream_active;
+}
+
+/*******************************************************************************
+* Function Name: pwm_stream_descriptor_init
+********************************************************************************
+* Summary:
+* Sets up the 2D descriptor of one half. Each trigger runs one X loop, which
+* copies a pair into CC0_BUFF and CC1_BUFF; the Y loop walks the table rows.
+*
+* Parameters:
+*  half - descriptor index, 0 or 1
+*  src - first pair of the half
+*  rows - number of pairs in the half
+*  loop - true to chain to the other half, false to stop after this one
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void pwm_stream_descriptor_init(uint32_t half,
+                                       const pwm_stream_pair_t *src,
+                                       uint32_t rows, bool loop)
+{
+    const cy_stc_dma_descriptor_config_t descriptor_config =
+    {
+        .retrigger       = CY_DMA_RETRIG_IM,
+        .interruptType   = CY_DMA_DESCR,
+        .triggerOutType  = CY_DMA_X_LOOP,
+        .channelState    = loop ? CY_DMA_CHANNEL_ENABLED :
+                                  CY_DMA_CHANNEL_DISABLED,
+        .triggerInType   = CY_DMA_X_LOOP,
+        .dataSize        = CY_DMA_WORD,
+        .srcTransferSize = CY_DMA_TRANSFER_SIZE_DATA,
+        .dstTransferSize = CY_DMA_TRANSFER_SIZE_DATA,
+        .descriptorType  = CY_DMA_2D_TRANSFER,
+        .srcAddress      = (void *)src,
+        .dstAddress      = (void *)cc0_buff_reg,
+        .srcXincrement   = 1,
+        .dstXincrement   = (int32_t)CC_BUFF_STRIDE_WORDS,
+        .xCount          = PAIR_WORDS,
+        .srcYincrement   = (int32_t)PAIR_WORDS,
+        .dstYincrement   = 0,
+        .yCount          = rows,
+        .nextDescriptor  = loop ? &stream_descriptor[half ^ 1U] : NULL
+    };
+
+    if (CY_DMA_SUCCESS != Cy_DMA_Descriptor_Init(&stream_descriptor[half],
+                                                 &descriptor_config))
+    {
+        CY_ASSERT(0);
+    }
+}
+
+/*******************************************************************************
+* Function Name: pwm_stream_dma_isr
+********************************************************************************
+* Summary:
+* DataWire completion handler, runs once per played half. Applies a pending
+* table swap to the half that just finished and notifies the application.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void pwm_stream_dma_isr(void)
+{
+    uint32_t done_half = playing_half;
+
+    Cy_DMA_Channel_ClearInterrupt(PWM_STREAM_DW, PWM_STREAM_DW_CHANNEL);
+    playing_half = done_half ^ 1U;
+
+    /* Not looping: the channel stopped after the second half */
+    if ((1U == done_half) && (!stream_loop) && stream_active)
+    {
+        stream_active = false;
+        pwm_update_resume();
+    }
+
+    /* Re-point the idle half to the new table */
+    if ((0U != pending_halves) && (pending_halves == (2U - done_half)))
+    {
+        Cy_DMA_Descriptor_SetSrcAddress(&stream_descriptor[done_half],
+                                        &pending_table[done_half * half_rows]);
+        pending_halves--;
+    }
+
+    if (NULL != stream_callback)
+    {
+        stream_callback(done_half, stream_callback_arg);
+    }
+}
+
+#endif /* PWM_STREAM_ENABLE */
@@ -0,0 +1,78 @@
+/*******************************************************************************
+* File Name:   pwm_stream.h
+*
+* Description: Zero-CPU compare streaming. A DataWire channel triggered by
+* the terminal count output (tr_out0) of the counter copies one CC0/CC1 pair
+* per PWM period from a RAM table into the compare buffer registers. Its
+* completion trigger drives the swap input of the counter, so the new pair is
+* swapped in at the following terminal count without any CPU involvement.
+* The table is played as two ping-pong halves; a callback reports each half
+* that completed so the application can refill it while the other half plays.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2020-2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef PWM_STREAM_H_
+#define PWM_STREAM_H_
+
+#include "cy_pdl.h"
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+/* One table entry. Both members are copied by the DMA on the same trigger. */
+typedef struct
+{
+    uint32_t compare0; /* Value for the CC0 buffer register */
+    uint32_t compare1; /* Value for the CC1 buffer register */
+} pwm_stream_pair_t;
+
+/* Called from the DMA interrupt when half (0 or 1) finished playing */
+typedef void (*pwm_stream_callback_t)(uint32_t half, void *callback_arg);
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+void pwm_stream_init(TCPWM_Type *base, uint32_t cnt_num);
+bool pwm_stream_load(const pwm_stream_pair_t *table, uint32_t length,
+                     bool loop);
+bool pwm_stream_swap(const pwm_stream_pair_t *table, uint32_t length);
+void pwm_stream_register_callback(pwm_stream_callback_t callback,
+                                  void *callback_arg);
+void pwm_stream_start(void);
+void pwm_stream_stop(void);
+bool pwm_stream_is_active(void);
+
+#endif /* PWM_STREAM_H_ */
@@ -0,0 +1,158 @@
+/*******************************************************************************
+* File Name:   pwm_svpwm.c
+*
+* Description: Space-vector PWM for a three-phase channel set. The sector is
+* found from the signs of the three line voltages, which index a table of
+* the phases with the highest and the lowest voltage. The common-mode offset
+* that centers these two, and with them the active vectors, in the period is
+* then computed without compares. This equals the classic sector based
+* space-vector modulation with equal zero vectors and needs only integer
+* multiplies and shifts.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include "pwm_port.h"
+#include "pwm_math.h"
+#if !defined(PWM_PORT_HOST)
+#include "pwm_channels.h"
+#endif
+#include "pwm_svpwm.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define SQRT3_2_Q15             (28378L) /* sqrt(3) / 2 in Q15 */
+#define INV_SQRT3_Q15           (18919L) /* 1 / sqrt(3) in Q15 */
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+/* Phases with the highest and the lowest voltage, indexed by the sector
+ * bits (va > vb) | (vb > vc) << 1 | (vc > va) << 2. Index 0 is the zero
+ * vector and index 7 cannot occur. */
+static const uint8_t sector_max[8] = { 0U, 0U, 1U, 0U, 2U, 2U, 1U, 0U };
+static const uint8_t sector_min[8] = { 0U, 1U, 2U, 2U, 0U, 1U, 0U, 0U };
+
+/*******************************************************************************
+* Function Name: pwm_svpwm_duty
+********************************************************************************
+* Summary:
+* Converts a voltage vector to the duty cycles of the three phases. The
+* vector is normalized to Vdc / sqrt(3), the radius of the circle inscribed
+* in the hexagon, so a magnitude up to 1.0 is modulated linearly. Longer
+* vectors are clipped phase by phase.
+*
+* Parameters:
+*  alpha - alpha component in Q15
+*  beta - beta component in Q15
+*  duty - resulting duty cycles of phases a, b and c in Q15, 0 to
+*         PWM_MATH_Q15_ONE
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void pwm_svpwm_duty(int32_t alpha, int32_t beta,
+                    int32_t duty[PWM_SVPWM_PHASES])
+{
+    int32_t voltage[PWM_SVPWM_PHASES];
+    int32_t offset;
+    uint32_t sector;
+    uint32_t phase;
+
+    /* Inverse Clarke transform */
+    voltage[0] = alpha;
+    voltage[1] = -(alpha >> 1) + ((SQRT3_2_Q15 * beta) >> 15);
+    voltage[2] = -(alpha >> 1) - ((SQRT3_2_Q15 * beta) >> 15);
+
+    sector = (uint32_t)(voltage[0] > voltage[1]) |
+             ((uint32_t)(voltage[1] > voltage[2]) << 1U) |
+             ((uint32_t)(voltage[2] > voltage[0]) << 2U);
+
+    /* Center the highest and the lowest phase in the period */
+    offset = -((voltage[sector_max[sector]] + voltage[sector_min[sector]]) >> 1);
+
+    for (phase = 0U; phase < PWM_SVPWM_PHASES; phase++)
+    {
+        duty[phase] = pwm_math_clamp((PWM_MATH_Q15_ONE / 2) +
+                                     (((voltage[phase] + offset) *
+                                       INV_SQRT3_Q15) >> 15),
+                                     PWM_MATH_Q15_ONE);
+    }
+}
+
+#if !defined(PWM_PORT_HOST)
+/*******************************************************************************
+* Function Name: pwm_svpwm_stage
+********************************************************************************
+* Summary:
+* Stages the duty cycles of the three phases to channels 0 to 2 of a channel
+* set; pwm_channels_commit() then swaps them in on the same terminal count.
+* The up-counting half of the period uses duty_up through CC0, the
+* down-counting half duty_down through CC1. Pass the same duty cycles twice
+* for the symmetric pattern of one vector per period.
+*
+* Parameters:
+*  set - channel set of at least three channels, phases a, b and c
+*  math - conversion context of the period of the set
+*  duty_up - duty cycles from pwm_svpwm_duty() for the first half period
+*  duty_down - duty cycles from pwm_svpwm_duty() for the second half period
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void pwm_svpwm_stage(pwm_channel_set_t *set, const pwm_math_t *math,
+                     const int32_t duty_up[PWM_SVPWM_PHASES],
+                     const int32_t duty_down[PWM_SVPWM_PHASES])
+{
+    uint32_t phase;
+
+    CY_ASSERT(set->count >= PWM_SVPWM_PHASES);
+
+    /* A half period at the duty cycle d is high for d * P ticks, from
+     * CC0 = P - d * P up to the peak and from the peak down to CC1 */
+    for (phase = 0U; phase < PWM_SVPWM_PHASES; phase++)
+    {
+        pwm_channels_set(set, phase,
+                         (uint32_t)(math->period -
+                                    ((duty_up[phase] * math->period) >> 15)),
+                         (uint32_t)(math->period -
+                                    ((duty_down[phase] * math->period) >> 15)));
+    }
+}
+#endif
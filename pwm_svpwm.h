@@ -0,0 +1,72 @@
+/*******************************************************************************
+* File Name:   pwm_svpwm.h
+*
+* Description: Space-vector PWM for a three-phase channel set in the
+* center-aligned asymmetric CC0/CC1 mode. Converts an (alpha, beta) voltage
+* vector in Q15 to the duty cycles of the three phases and stages them as
+* CC0/CC1 pairs. CC0 acts while the counter counts up and CC1 while it
+* counts down, so each half period can carry its own vector, which doubles
+* the modulation rate at the cost of one grouped swap per period.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef PWM_SVPWM_H_
+#define PWM_SVPWM_H_
+
+#include "pwm_port.h"
+#include "pwm_math.h"
+#if !defined(PWM_PORT_HOST)
+#include "pwm_channels.h"
+#endif
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define PWM_SVPWM_PHASES        (3U)
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+void pwm_svpwm_duty(int32_t alpha, int32_t beta,
+                    int32_t duty[PWM_SVPWM_PHASES]);
+#if !defined(PWM_PORT_HOST)
+void pwm_svpwm_stage(pwm_channel_set_t *set, const pwm_math_t *math,
+                     const int32_t duty_up[PWM_SVPWM_PHASES],
+                     const int32_t duty_down[PWM_SVPWM_PHASES]);
+#endif
+
+#endif /* PWM_SVPWM_H_ */
@@ -0,0 +1,89 @@
+/*******************************************************************************
+* File Name:   pwm_sync.c
+*
+* Description: External sync input for multi-board phase alignment. The
+* sync pin is connected through the trigger multiplexer to the reload and
+* swap inputs of the counter. Reload starts a stopped counter and restarts a
+* running one from the beginning of the period, so the PWM of every board
+* is aligned to the edge. The swap request of the same edge makes the
+* buffered values active at the following terminal count, which is then also
+* common to all boards. No software runs between the edge and either action.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include "cy_pdl.h"
+#include "app_config.h"
+#include "pwm_sync.h"
+
+#if (PWM_SYNC_ENABLE)
+
+/*******************************************************************************
+* Function Name: pwm_sync_init
+********************************************************************************
+* Summary:
+* Connects the sync pin to the reload and swap inputs of the counter. The
+* counter must be initialized and enabled but not started by software; it
+* starts on the first sync edge.
+*
+* Parameters:
+*  base - TCPWM block base address
+*  cnt_num - counter number within the block
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void pwm_sync_init(TCPWM_Type *base, uint32_t cnt_num)
+{
+    /* The pin feeds the trigger multiplexer through its HSIOM function */
+    Cy_GPIO_Pin_FastInit(PWM_SYNC_PORT, PWM_SYNC_PIN, CY_GPIO_DM_HIGHZ, 0UL,
+                         PWM_SYNC_HSIOM);
+
+    /* The sync is passed as a level, the counter detects the edge */
+    if (CY_RSLT_SUCCESS != Cy_TrigMux_Connect(PWM_SYNC_TRIG_IN,
+                                              PWM_SYNC_TRIG_OUT, false,
+                                              TRIGGER_TYPE_LEVEL))
+    {
+        CY_ASSERT(0);
+    }
+    Cy_TCPWM_InputTriggerSetup(base, cnt_num, CY_TCPWM_INPUT_TR_RELOAD_OR_INDEX,
+                               CY_TCPWM_INPUT_RISINGEDGE, PWM_SYNC_INPUT);
+    Cy_TCPWM_InputTriggerSetup(base, cnt_num, CY_TCPWM_INPUT_TR_CAPTURE0,
+                               CY_TCPWM_INPUT_RISINGEDGE, PWM_SYNC_INPUT);
+}
+
+#endif /* PWM_SYNC_ENABLE */
@@ -0,0 +1,963 @@
+/*******************************************************************************
+* File Name:   pwm_update.c
+*
+* Description: Compare update engine for the dual compare/capture PWM. New
+* CC0/CC1 pairs are staged into a double-buffered shadow block from thread or
+* lower-priority interrupt context and committed from the TCPWM terminal
+* count interrupt, so exactly one buffered swap is issued per PWM period and
+* it always takes effect on the period boundary. With
+* PWM_UPDATE_PERIOD_SWAP_ENABLE the period is buffered as well, so a new
+* period and its compare pair swap in together.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2020-2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include "cy_pdl.h"
+#include "pwm_port.h"
+#include "cybsp.h"
+#include "latency_trace.h"
+#include "pwm_update.h"
+#include "pwm_regs.h"
+#include "pwm_math.h"
+#include "pwm_ramp.h"
+#include "telemetry.h"
+#include "pwm_regulator.h"
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+typedef struct
+{
+    uint32_t period;    /* Value for the period buffer register */
+    uint32_t compare0;  /* Value for the CC0 buffer register */
+    uint32_t compare1;  /* Value for the CC1 buffer register */
+    uint32_t slew;      /* Largest compare step per period in Q16.16 ticks,
+                         * 0 to apply the compare pair at once */
+#if (PWM_UPDATE_DEAD_TIME_ENABLE)
+    uint32_t dead_time; /* Value for the dead time buffer register */
+    cy_en_line_select_config_t line_compl; /* Select of line_compl_out */
+#endif
+} pwm_compare_pair_t;
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+static TCPWM_Type *pwm_base; /* TCPWM block driven by the update engine */
+static uint32_t pwm_cnt_num; /* Counter number within the TCPWM block */
+static IRQn_Type pwm_irq; /* Interrupt line of the counter */
+
+/* Shadow copies of the buffered values. The stager writes the slot that is
+ * not published and then publishes it by flipping the index and advancing
+ * the sequence. The ISR copies the published slot and checks that the
+ * sequence did not move meanwhile, which would mean a stager running above
+ * its priority published twice and reused the slot being copied. Neither
+ * side ever masks interrupts. There must be a single staging context. */
+static pwm_compare_pair_t shadow[2];
+static pwm_compare_pair_t staged; /* Working copy of the staging context */
+static volatile uint32_t published_index = 0U;
+static volatile uint32_t publish_sequence = 0U; /* Advanced per publish */
+static volatile uint32_t committed_sequence = 0U; /* Of the last commit */
+
+/* State of the ramp, touched by the ISR only */
+static pwm_compare_pair_t ramp_target; /* Last published values */
+static pwm_compare_pair_t ramp_output; /* Last values written */
+static pwm_ramp_t ramp;
+static bool ramp_active = false; /* Output has not reached the target yet */
+static bool swap_pending = false; /* Swap requested on the last TC */
+static volatile uint32_t commit_count = 0U;
+static volatile uint32_t missed_count = 0U;   /* Swaps not on the next TC */
+static volatile uint32_t late_count = 0U;     /* Commits finished after TC */
+static volatile uint32_t overwrite_count = 0U; /* Publishes never committed,
+                                                * stager context only */
+
+#if (PWM_UPDATE_SEQUENCER_ENABLE)
+/* State of the sequencer. It is set up by the stager before it sets
+ * sequence_running; from then on only the ISR touches it until it clears
+ * sequence_running again. */
+static pwm_sequence_t sequence;
+static volatile bool sequence_running = false;
+static volatile bool sequence_stop = false; /* Stop requested */
+static volatile bool sequence_done = false; /* Set once the sequence ended */
+#endif
+#if (PWM_REGULATOR_ENABLE)
+static pwm_math_t regulator_math; /* Conversion context of the period */
+static bool regulating = false; /* Regulator controlled the last period */
+#endif
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+static void pwm_update_publish(const pwm_compare_pair_t *next);
+static uint32_t pwm_update_read(pwm_compare_pair_t *snapshot);
+static void pwm_update_write(const pwm_compare_pair_t *pair);
+static void pwm_update_write_buffers(const pwm_compare_pair_t *pair);
+static bool pwm_update_is_swapped(const pwm_compare_pair_t *pair);
+static bool pwm_update_is_tc_pending(void);
+#if (PWM_UPDATE_SEQUENCER_ENABLE)
+static void pwm_update_sequence_advance(void);
+#endif
+#if (PWM_REGULATOR_ENABLE)
+static void pwm_update_regulate(void);
+#endif
+
+/*******************************************************************************
+* Function Name: pwm_update_init
+********************************************************************************
+* Summary:
+* Enables the terminal count interrupt of the counter and hooks up the commit
+* ISR. The counter must already be initialized and enabled.
+*
+* Parameters:
+*  base - TCPWM block base address
+*  cnt_num - counter number within the block
+*  irq - interrupt line of the counter
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void pwm_update_init(TCPWM_Type *base, uint32_t cnt_num, IRQn_Type irq)
+{
+    const cy_stc_sysint_t pwm_irq_cfg =
+    {
+        .intrSrc = irq,
+        .intrPriority = PWM_UPDATE_IRQ_PRIORITY
+    };
+
+    pwm_base = base;
+    pwm_cnt_num = cnt_num;
+    pwm_irq = irq;
+#if (PWM_UPDATE_STATIC_CHANNEL)
+    /* The ISR is compiled for the counter of the configuration */
+    CY_ASSERT((PWM_UPDATE_HW == base) && (PWM_UPDATE_NUM == cnt_num));
+#endif
+
+    /* Start from the values currently programmed in the buffers */
+    shadow[0].period = Cy_TCPWM_PWM_GetPeriod0(base, cnt_num);
+    shadow[0].compare0 = Cy_TCPWM_PWM_GetCompare0BufVal(base, cnt_num);
+    shadow[0].compare1 = Cy_TCPWM_PWM_GetCompare1BufVal(base, cnt_num);
+#if (PWM_UPDATE_DEAD_TIME_ENABLE)
+    shadow[0].dead_time = 0U;
+    shadow[0].line_compl = CY_TCPWM_OUTPUT_CONSTANT_0;
+#endif
+    shadow[0].slew = PWM_UPDATE_SLEW_DEFAULT;
+    shadow[1] = shadow[0];
+    staged = shadow[0];
+    published_index = 0U;
+    committed_sequence = publish_sequence;
+    ramp_target = shadow[0];
+    ramp_output = shadow[0];
+    pwm_ramp_init(&ramp, shadow[0].compare0, shadow[0].compare1);
+    ramp_active = false;
+    swap_pending = false;
+
+#if (PWM_UPDATE_PERIOD_SWAP_ENABLE)
+    /* Every swap now also exchanges PERIOD and PERIOD_BUFF, so the buffer
+     * must hold the active period before the first swap. */
+    Cy_TCPWM_PWM_SetPeriod1(base, cnt_num, shadow[0].period);
+    Cy_TCPWM_PWM_EnablePeriodSwap(base, cnt_num, true);
+#endif
+
+#if (PWM_UPDATE_DEAD_TIME_ENABLE)
+    /* Start without dead time and with line_compl_out held low. The dead
+     * time buffer is exchanged together with the period buffer and the line
+     * select buffer once its auto reload is enabled, so the buffers must
+     * hold the same settings before the first swap. */
+    Cy_TCPWM_PWM_PWMDeadTime(base, cnt_num, 0U);
+    Cy_TCPWM_PWM_PWMDeadTimeN(base, cnt_num, 0U);
+    Cy_TCPWM_PWM_PWMDeadTimeBuff(base, cnt_num, 0U);
+    Cy_TCPWM_PWM_PWMDeadTimeBuffN(base, cnt_num, 0U);
+    (void)Cy_TCPWM_PWM_Configure_LineSelect(base, cnt_num,
+                                            CY_TCPWM_OUTPUT_PWM_SIGNAL,
+                                            shadow[0].line_compl);
+    (void)Cy_TCPWM_PWM_Configure_LineSelectBuff(base, cnt_num,
+                                                CY_TCPWM_OUTPUT_PWM_SIGNAL,
+                                                shadow[0].line_compl);
+    TCPWM_GRP_CNT_CTRL(base, TCPWM_GRP_CNT_GET_GRP(cnt_num), cnt_num) |=
+        TCPWM_GRP_CNT_V2_CTRL_AUTO_RELOAD_LINE_SEL_Msk;
+#endif
+
+    /* Interrupt on terminal count, i.e. once per PWM period */
+    Cy_TCPWM_ClearInterrupt(base, cnt_num, CY_TCPWM_INT_ON_TC);
+    Cy_TCPWM_SetInterruptMask(base, cnt_num, CY_TCPWM_INT_ON_TC);
+
+    if (CY_SYSINT_SUCCESS != Cy_SysInt_Init(&pwm_irq_cfg, pwm_update_isr))
+    {
+        CY_ASSERT(0);
+    }
+    NVIC_ClearPendingIRQ(pwm_irq_cfg.intrSrc);
+    NVIC_EnableIRQ(pwm_irq_cfg.intrSrc);
+}
+
+/*******************************************************************************
+* Function Name: pwm_update_stage
+********************************************************************************
+* Summary:
+* Stages a new compare pair. It is written to the compare buffers on the next
+* terminal count and becomes active one period later, or is approached at
+* the slew rate set by pwm_update_set_slew(). A pair staged again before it
+* is committed replaces the previous one; a pair staged during a ramp becomes
+* the new target. The period of the last staged pair is kept.
+*
+* Parameters:
+*  compare0 - new CC0 value
+*  compare1 - new CC1 value
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void pwm_update_stage(uint32_t compare0, uint32_t compare1)
+{
+    staged.compare0 = compare0;
+    staged.compare1 = compare1;
+    pwm_update_publish(&staged);
+}
+
+/*******************************************************************************
+* Function Name: pwm_update_stage_period
+********************************************************************************
+* Summary:
+* Stages a new period together with its compare pair. All three values are
+* swapped in on the same terminal count, so the PWM frequency changes without
+* a stall or an extra cycle. A period change is never ramped. Requires
+* PWM_UPDATE_PERIOD_SWAP_ENABLE; without it the period is ignored.
+*
+* Parameters:
+*  period - new period in counter ticks
+*  compare0 - new CC0 value, at most period
+*  compare1 - new CC1 value, at most period
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void pwm_update_stage_period(uint32_t period, uint32_t compare0,
+                             uint32_t compare1)
+{
+    staged.period = period;
+    staged.compare0 = compare0;
+    staged.compare1 = compare1;
+    pwm_update_publish(&staged);
+}
+
+/*******************************************************************************
+* Function Name: pwm_update_set_slew
+********************************************************************************
+* Summary:
+* Sets the slew rate of the compare values. With a non-zero rate the
+* terminal count ISR moves CC0 and CC1 toward the last staged pair by at most
+* this step on every period, so a large duty cycle or phase change does not
+* cause a current spike. The main loop is not involved in the ramp. The rate
+* is only stored in the working copy and takes effect with the next
+* pwm_update_stage() or pwm_update_stage_period() call.
+*
+* Parameters:
+*  slew - largest change of CC0 and CC1 per period in Q16.16 counter ticks,
+*         0 to apply staged pairs at once
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void pwm_update_set_slew(uint32_t slew)
+{
+    staged.slew = slew;
+}
+
+#if (PWM_UPDATE_DEAD_TIME_ENABLE)
+/*******************************************************************************
+* Function Name: pwm_update_stage_output
+********************************************************************************
+* Summary:
+* Stores the dead time and the complementary output in the working copy.
+* They are published by the next pwm_update_stage() or
+* pwm_update_stage_period() call and swapped in on the same terminal count
+* as that compare pair, so a dead time change never meets a compare pair it
+* was not meant for and cannot produce an overlap of line_out and
+* line_compl_out.
+*
+* Parameters:
+*  dead_time - dead time to insert at both edges, in counter clocks, at most
+*              PWM_UPDATE_DEAD_TIME_MAX
+*  complementary - true to drive line_compl_out with the inverted PWM signal,
+*                  false to hold it low
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void pwm_update_stage_output(uint32_t dead_time, bool complementary)
+{
+    staged.dead_time = dead_time;
+    staged.line_compl = complementary ? CY_TCPWM_OUTPUT_INVERTED_PWM_SIGNAL :
+                                        CY_TCPWM_OUTPUT_CONSTANT_0;
+}
+#endif
+
+#if (PWM_UPDATE_SEQUENCER_ENABLE)
+/*******************************************************************************
+* Function Name: pwm_update_run_sequence
+********************************************************************************
+* Summary:
+* Starts playing a table of steps from the terminal count ISR. Each step is
+* applied like a staged pair, including the slew rate, and is held for its
+* dwell count of periods before the ISR moves on to the next step, so the
+* main loop is not involved until the sequence ends. Values published while
+* the sequence runs are held back; when it ends, the last published values
+* are applied again and pwm_update_get_sequence_done() reports the end.
+* The table must stay unchanged while the sequence runs. A step period
+* requires PWM_UPDATE_PERIOD_SWAP_ENABLE; without it the period is ignored.
+*
+* Parameters:
+*  steps - table of steps, with compare values at most the step period
+*  count - number of steps in the table
+*  repeat - number of passes through the table, 0 to repeat until stopped
+*
+* Return:
+*  bool - true if the sequence was started, false if a sequence is already
+*         running or the table is empty or has a step with zero dwell
+*
+*******************************************************************************/
+bool pwm_update_run_sequence(const pwm_update_step_t *steps, uint32_t count,
+                             uint32_t repeat)
+{
+    uint32_t index;
+
+    if (sequence_running || (NULL == steps) || (0U == count))
+    {
+        return false;
+    }
+    for (index = 0U; index < count; index++)
+    {
+        if (0U == steps[index].dwell)
+        {
+            return false;
+        }
+    }
+
+    /* The first step is loaded on the next terminal count */
+    pwm_sequence_start(&sequence, steps, count, repeat);
+    sequence_stop = false;
+    sequence_done = false;
+
+    /* Hand the state over to the ISR only after it is complete */
+    __DMB();
+    sequence_running = true;
+
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: pwm_update_stop_sequence
+********************************************************************************
+* Summary:
+* Requests the running sequence to end on the next terminal count. The end
+* is reported by pwm_update_get_sequence_done() as for a completed sequence.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void pwm_update_stop_sequence(void)
+{
+    if (sequence_running)
+    {
+        sequence_stop = true;
+    }
+}
+
+/*******************************************************************************
+* Function Name: pwm_update_is_sequence_running
+********************************************************************************
+* Summary:
+* Returns whether the terminal count ISR is playing a sequence, in which case
+* its table must not be changed.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  bool - true while a sequence runs
+*
+*******************************************************************************/
+bool pwm_update_is_sequence_running(void)
+{
+    return sequence_running;
+}
+
+/*******************************************************************************
+* Function Name: pwm_update_get_sequence_done
+********************************************************************************
+* Summary:
+* Reports the end of a sequence, either completed or stopped. Returns true
+* once per sequence.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  bool - true if a sequence ended since the last call
+*
+*******************************************************************************/
+bool pwm_update_get_sequence_done(void)
+{
+    bool done = sequence_done;
+
+    if (done)
+    {
+        sequence_done = false;
+    }
+
+    return done;
+}
+#endif /* PWM_UPDATE_SEQUENCER_ENABLE */
+
+/*******************************************************************************
+* Function Name: pwm_update_suspend
+********************************************************************************
+* Summary:
+* Stops the terminal count ISR, so another writer of the compare buffers, such
+* as the DataWire stream, owns them. Values staged meanwhile are kept and
+* applied by pwm_update_resume(); a running sequence and the regulator pause.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void pwm_update_suspend(void)
+{
+    NVIC_DisableIRQ(pwm_irq);
+    __DSB();
+    __ISB();
+}
+
+/*******************************************************************************
+* Function Name: pwm_update_resume
+********************************************************************************
+* Summary:
+* Restarts the terminal count ISR after pwm_update_suspend(). The ramp starts
+* from the compare pair the other writer left active and moves to the last
+* published values at their slew rate. Must be called while the ISR is still
+* suspended, i.e. once per suspend.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void pwm_update_resume(void)
+{
+    ramp_output.compare0 = Cy_TCPWM_PWM_GetCompare0Val(pwm_base, pwm_cnt_num);
+    ramp_output.compare1 = Cy_TCPWM_PWM_GetCompare1Val(pwm_base, pwm_cnt_num);
+    pwm_ramp_init(&ramp, ramp_output.compare0, ramp_output.compare1);
+    committed_sequence = pwm_update_read(&ramp_target);
+    ramp_active = true;
+    swap_pending = false;
+
+    /* Drop the terminal counts seen while suspended */
+    Cy_TCPWM_ClearInterrupt(pwm_base, pwm_cnt_num, CY_TCPWM_INT_ON_TC);
+    NVIC_ClearPendingIRQ(pwm_irq);
+    NVIC_EnableIRQ(pwm_irq);
+}
+
+/*******************************************************************************
+* Function Name: pwm_update_isr
+********************************************************************************
+* Summary:
+* Terminal count interrupt handler. Picks up newly published values and, while
+* the output differs from them, writes the next compare pair (and period,
+* dead time and line select) into the buffer registers and triggers one swap,
+* which the hardware carries out at the next terminal count. With a slew rate
+* the pair steps toward the target by at most the rate per period; a new
+* period is applied at once, as a ramp across two periods would mix scales.
+* While a sequence runs, its steps take the place of the published values,
+* and while the regulator runs, its output takes the place of both.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+PWM_RAMFUNC_BEGIN
+void pwm_update_isr(void)
+{
+    pwm_compare_pair_t next;
+
+    Cy_TCPWM_ClearInterrupt(pwm_base, pwm_cnt_num, CY_TCPWM_INT_ON_TC);
+
+    /* The swap requested on the previous terminal count must have moved the
+     * written pair into CC0/CC1 by now. If not, the ISR ran too late and the
+     * pair only becomes active one period later. */
+    if (swap_pending)
+    {
+        if (!pwm_update_is_swapped(&ramp_output))
+        {
+            missed_count++;
+        }
+        swap_pending = false;
+    }
+
+#if (PWM_REGULATOR_ENABLE)
+    if (pwm_regulator_is_running())
+    {
+        pwm_update_regulate();
+        regulating = true;
+    }
+    else if (regulating)
+    {
+        /* Return to the values published before or during regulation */
+        committed_sequence = pwm_update_read(&ramp_target);
+        ramp_active = true;
+        regulating = false;
+    }
+    else
+#endif
+#if (PWM_UPDATE_SEQUENCER_ENABLE)
+    if (sequence_running)
+    {
+        pwm_update_sequence_advance();
+    }
+    else
+#endif
+    if (publish_sequence != committed_sequence)
+    {
+        committed_sequence = pwm_update_read(&ramp_target);
+        ramp_active = true;
+    }
+
+    if (ramp_active)
+    {
+        next = ramp_target;
+        ramp_active = pwm_ramp_step(&ramp, ramp_target.compare0,
+                                    ramp_target.compare1, ramp_target.slew,
+                                    (ramp_target.period != ramp_output.period),
+                                    &next.compare0, &next.compare1);
+
+        pwm_update_write(&next);
+        ramp_output = next;
+        /* The swap of the sync input is not bound to the next terminal
+         * count, so it cannot be checked there */
+        swap_pending = !(PWM_SYNC_ENABLE);
+
+        /* A terminal count during the commit may have come before the swap
+         * request, which then only takes effect one period later */
+        if (pwm_update_is_tc_pending())
+        {
+            late_count++;
+        }
+
+        commit_count++;
+    }
+#if (PWM_SYNC_ENABLE)
+    else
+    {
+        /* A swap exchanges the buffers with the active values, so without a
+         * refill the next sync edge would swap the previous pair back in */
+        pwm_update_write_buffers(&ramp_output);
+    }
+#endif
+
+#if (TELEMETRY_ENABLE)
+    telemetry_tick(ramp_output.period, ramp_output.compare0,
+                   ramp_output.compare1);
+#endif
+}
+PWM_RAMFUNC_END
+
+/*******************************************************************************
+* Function Name: pwm_update_get_commit_count
+********************************************************************************
+* Summary:
+* Returns the number of compare pairs committed since initialization,
+* including the intermediate steps of ramps.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  uint32_t - commit count
+*
+*******************************************************************************/
+uint32_t pwm_update_get_commit_count(void)
+{
+    return commit_count;
+}
+
+/*******************************************************************************
+* Function Name: pwm_update_get_missed_count
+********************************************************************************
+* Summary:
+* Returns the number of commits whose swap did not take place on the
+* terminal count after the buffer write, because the ISR was delayed past
+* it. Such a pair becomes active one period late.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  uint32_t - missed swap count
+*
+*******************************************************************************/
+uint32_t pwm_update_get_missed_count(void)
+{
+    return missed_count;
+}
+
+/*******************************************************************************
+* Function Name: pwm_update_get_overwrite_count
+********************************************************************************
+* Summary:
+* Returns the number of staged value sets that were replaced by a newer set
+* before the terminal count ISR picked them up, so they never reached the
+* output. This includes sets staged while a sequence runs. Staging faster
+* than the PWM rate makes the count grow.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  uint32_t - overwrite count
+*
+*******************************************************************************/
+uint32_t pwm_update_get_overwrite_count(void)
+{
+    return overwrite_count;
+}
+
+/*******************************************************************************
+* Function Name: pwm_update_get_late_count
+********************************************************************************
+* Summary:
+* Returns the number of commits during which the next terminal count already
+* occurred, i.e. the ISR started too late in the period or took too long.
+* The swap of such a commit may take effect one period late, which is then
+* also counted by pwm_update_get_missed_count().
+*
+* Parameters:
+*  void
+*
+* Return:
+*  uint32_t - late commit count
+*
+*******************************************************************************/
+uint32_t pwm_update_get_late_count(void)
+{
+    return late_count;
+}
+
+/*******************************************************************************
+* Function Name: pwm_update_publish
+********************************************************************************
+* Summary:
+* Copies the staged values into the slot that is not published and publishes
+* it for the next terminal count.
+*
+* Parameters:
+*  next - values to commit
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void pwm_update_publish(const pwm_compare_pair_t *next)
+{
+    uint32_t index = published_index ^ 1U;
+
+    /* The previous publish is still waiting for the ISR */
+    if (publish_sequence != committed_sequence)
+    {
+        overwrite_count++;
+    }
+
+    shadow[index] = *next;
+
+    /* Publish the slot only after all values are stored */
+    __DMB();
+    published_index = index;
+    publish_sequence++;
+}
+
+/*******************************************************************************
+* Function Name: pwm_update_read
+********************************************************************************
+* Summary:
+* Copies the published slot. The copy is retried if a publish happened while
+* copying, which can only occur when the stager preempted the caller; the
+* stager runs to completion first, so the retry loop needs no waiting.
+*
+* Parameters:
+*  snapshot - receives a consistent copy of the published values
+*
+* Return:
+*  uint32_t - publish sequence the copy belongs to
+*
+*******************************************************************************/
+PWM_RAMFUNC_BEGIN
+static uint32_t pwm_update_read(pwm_compare_pair_t *snapshot)
+{
+    uint32_t sequence;
+
+    do
+    {
+        sequence = publish_sequence;
+        __DMB();
+        *snapshot = shadow[published_index];
+        __DMB();
+    } while (sequence != publish_sequence);
+
+    return sequence;
+}
+PWM_RAMFUNC_END
+
+/*******************************************************************************
+* Function Name: pwm_update_write
+********************************************************************************
+* Summary:
+* Writes a set of values into the buffer registers and requests the swap.
+* With PWM_SYNC_ENABLE the swap is requested by the sync input instead.
+*
+* Parameters:
+*  pair - values to swap in at the next terminal count
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+PWM_RAMFUNC_BEGIN
+static void pwm_update_write(const pwm_compare_pair_t *pair)
+{
+    pwm_update_write_buffers(pair);
+    LATENCY_TRACE_COMMIT_MARK(LATENCY_STAGE_BUFFER_WRITE);
+#if (PWM_SYNC_ENABLE)
+    /* The edge of the sync input requests the swap on all boards */
+#elif (PWM_UPDATE_STATIC_CHANNEL)
+    PWM_REGS_TRIGGER_SWAP(PWM_UPDATE_HW, PWM_UPDATE_NUM);
+#else
+    Cy_TCPWM_TriggerCaptureOrSwap_Single(pwm_base, pwm_cnt_num);
+#endif
+    LATENCY_TRACE_COMMIT_MARK(LATENCY_STAGE_SWAP_TRIGGER);
+    LATENCY_TRACE_COMMIT_END();
+}
+PWM_RAMFUNC_END
+
+/*******************************************************************************
+* Function Name: pwm_update_write_buffers
+********************************************************************************
+* Summary:
+* Writes a set of values into the buffer registers.
+*
+* Parameters:
+*  pair - values for the buffer registers
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+PWM_RAMFUNC_BEGIN
+static void pwm_update_write_buffers(const pwm_compare_pair_t *pair)
+{
+#if (PWM_UPDATE_STATIC_CHANNEL)
+    PWM_REGS_CC0_BUFF(PWM_UPDATE_HW, PWM_UPDATE_NUM) = pair->compare0;
+    PWM_REGS_CC1_BUFF(PWM_UPDATE_HW, PWM_UPDATE_NUM) = pair->compare1;
+#if (PWM_UPDATE_PERIOD_SWAP_ENABLE)
+    PWM_REGS_PERIOD_BUFF(PWM_UPDATE_HW, PWM_UPDATE_NUM) = pair->period;
+#endif
+#else
+    Cy_TCPWM_PWM_SetCompare0BufVal(pwm_base, pwm_cnt_num, pair->compare0);
+    Cy_TCPWM_PWM_SetCompare1BufVal(pwm_base, pwm_cnt_num, pair->compare1);
+#if (PWM_UPDATE_PERIOD_SWAP_ENABLE)
+    Cy_TCPWM_PWM_SetPeriod1(pwm_base, pwm_cnt_num, pair->period);
+#endif
+#endif
+#if (PWM_UPDATE_DEAD_TIME_ENABLE)
+    Cy_TCPWM_PWM_PWMDeadTimeBuff(pwm_base, pwm_cnt_num, pair->dead_time);
+    Cy_TCPWM_PWM_PWMDeadTimeBuffN(pwm_base, pwm_cnt_num, pair->dead_time);
+    (void)Cy_TCPWM_PWM_Configure_LineSelectBuff(pwm_base, pwm_cnt_num,
+                                                CY_TCPWM_OUTPUT_PWM_SIGNAL,
+                                                pair->line_compl);
+#endif
+}
+PWM_RAMFUNC_END
+
+/*******************************************************************************
+* Function Name: pwm_update_is_swapped
+********************************************************************************
+* Summary:
+* Checks whether a written compare pair has been swapped into CC0 and CC1.
+* A pair equal to the values it replaced always passes.
+*
+* Parameters:
+*  pair - values written by the last commit
+*
+* Return:
+*  bool - true if CC0 and CC1 hold the pair
+*
+*******************************************************************************/
+PWM_RAMFUNC_BEGIN
+static bool pwm_update_is_swapped(const pwm_compare_pair_t *pair)
+{
+#if (PWM_UPDATE_STATIC_CHANNEL)
+    return (PWM_REGS_CC0(PWM_UPDATE_HW, PWM_UPDATE_NUM) == pair->compare0) &&
+           (PWM_REGS_CC1(PWM_UPDATE_HW, PWM_UPDATE_NUM) == pair->compare1);
+#else
+    return (Cy_TCPWM_PWM_GetCompare0Val(pwm_base, pwm_cnt_num) ==
+            pair->compare0) &&
+           (Cy_TCPWM_PWM_GetCompare1Val(pwm_base, pwm_cnt_num) ==
+            pair->compare1);
+#endif
+}
+PWM_RAMFUNC_END
+
+/*******************************************************************************
+* Function Name: pwm_update_is_tc_pending
+********************************************************************************
+* Summary:
+* Checks whether a terminal count occurred since the ISR cleared the
+* interrupt.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  bool - true if the terminal count interrupt is pending again
+*
+*******************************************************************************/
+PWM_RAMFUNC_BEGIN
+static bool pwm_update_is_tc_pending(void)
+{
+#if (PWM_UPDATE_STATIC_CHANNEL)
+    return (0U != (PWM_REGS_INTR(PWM_UPDATE_HW, PWM_UPDATE_NUM) &
+                   CY_TCPWM_INT_ON_TC));
+#else
+    return (0U != (Cy_TCPWM_GetInterruptStatus(pwm_base, pwm_cnt_num) &
+                   CY_TCPWM_INT_ON_TC));
+#endif
+}
+PWM_RAMFUNC_END
+
+#if (PWM_UPDATE_SEQUENCER_ENABLE)
+/*******************************************************************************
+* Function Name: pwm_update_sequence_advance
+********************************************************************************
+* Summary:
+* Runs the sequencer for one period (see pwm_sequence.h) and makes a new
+* step the ramp target. At the end of the last pass, or on a stop request,
+* the published values become the target again and the end is reported.
+* Runs in the terminal count ISR.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+PWM_RAMFUNC_BEGIN
+static void pwm_update_sequence_advance(void)
+{
+    const pwm_update_step_t *step = NULL;
+    pwm_sequence_event_t event;
+
+    event = pwm_sequence_advance(&sequence, sequence_stop, &step);
+    if (PWM_SEQUENCE_END == event)
+    {
+        /* Return to the values published before or during the sequence */
+        committed_sequence = pwm_update_read(&ramp_target);
+        ramp_active = true;
+        sequence_stop = false;
+        sequence_running = false;
+        sequence_done = true;
+    }
+    else if (PWM_SEQUENCE_STEP == event)
+    {
+        ramp_target.compare0 = step->compare0;
+        ramp_target.compare1 = step->compare1;
+#if (PWM_UPDATE_PERIOD_SWAP_ENABLE)
+        if (0U != step->period)
+        {
+            ramp_target.period = step->period;
+        }
+#endif
+        ramp_active = true;
+    }
+}
+PWM_RAMFUNC_END
+#endif /* PWM_UPDATE_SEQUENCER_ENABLE */
+
+#if (PWM_REGULATOR_ENABLE)
+/*******************************************************************************
+* Function Name: pwm_update_regulate
+********************************************************************************
+* Summary:
+* Runs one period of the regulator and makes its duty cycle the target of the
+* next commit, as a centered compare pair applied without slew. The period
+* stays the one of the last target.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+PWM_RAMFUNC_BEGIN
+static void pwm_update_regulate(void)
+{
+    int32_t duty = pwm_regulator_step();
+
+    /* pwm_math_init() divides, so it only runs for a new period */
+    if (regulator_math.period != (int32_t)ramp_target.period)
+    {
+        pwm_math_init(&regulator_math, ramp_target.period);
+    }
+
+    pwm_math_to_compare(&regulator_math, duty, 0, &ramp_target.compare0,
+                        &ramp_target.compare1);
+    ramp_target.slew = 0U;
+    ramp_active = true;
+}
+PWM_RAMFUNC_END
+#endif
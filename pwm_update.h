@@ -0,0 +1,93 @@
+/*******************************************************************************
+* File Name:   pwm_update.h
+*
+* Description: Compare update engine for the dual compare/capture PWM. New
+* CC0/CC1 pairs are staged into a double-buffered shadow block from thread or
+* lower-priority interrupt context and committed from the TCPWM terminal
+* count interrupt, so exactly one buffered swap is issued per PWM period and
+* it always takes effect on the period boundary. With
+* PWM_UPDATE_PERIOD_SWAP_ENABLE the period is buffered as well, so a new
+* period and its compare pair swap in together.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2020-2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef PWM_UPDATE_H_
+#define PWM_UPDATE_H_
+
+#include "cy_pdl.h"
+#include "app_config.h"
+#include "pwm_sequence.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define PWM_UPDATE_IRQ_PRIORITY (1) /* Above the UART so commits are on time */
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+#if (PWM_UPDATE_SEQUENCER_ENABLE)
+/* One step of a sequence played by the terminal count ISR */
+typedef pwm_sequence_step_t pwm_update_step_t;
+#endif
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+void pwm_update_init(TCPWM_Type *base, uint32_t cnt_num, IRQn_Type irq);
+void pwm_update_stage(uint32_t compare0, uint32_t compare1);
+void pwm_update_stage_period(uint32_t period, uint32_t compare0,
+                             uint32_t compare1);
+void pwm_update_set_slew(uint32_t slew);
+#if (PWM_UPDATE_DEAD_TIME_ENABLE)
+void pwm_update_stage_output(uint32_t dead_time, bool complementary);
+#endif
+#if (PWM_UPDATE_SEQUENCER_ENABLE)
+bool pwm_update_run_sequence(const pwm_update_step_t *steps, uint32_t count,
+                             uint32_t repeat);
+void pwm_update_stop_sequence(void);
+bool pwm_update_is_sequence_running(void);
+bool pwm_update_get_sequence_done(void);
+#endif
+void pwm_update_suspend(void);
+void pwm_update_resume(void);
+void pwm_update_isr(void);
+uint32_t pwm_update_get_commit_count(void);
+uint32_t pwm_update_get_missed_count(void);
+uint32_t pwm_update_get_overwrite_count(void);
+uint32_t pwm_update_get_late_count(void);
+
+#endif /* PWM_UPDATE_H_ */
@@ -0,0 +1,299 @@
+/*******************************************************************************
+* File Name:   ring_buffer.h
+*
+* Description: Lock-free single-producer/single-consumer byte ring buffer. One
+* context (typically an interrupt handler) only pushes and one context
+* (typically the main loop) only pops, so no critical sections are needed. The
+* storage size must be a power of two.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2020-2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef RING_BUFFER_H_
+#define RING_BUFFER_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "cy_pdl.h"
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+typedef struct
+{
+    uint8_t *data;          /* Storage, size is (mask + 1) bytes */
+    uint32_t mask;          /* Storage size minus one */
+    volatile uint32_t head; /* Next write index, written by producer only */
+    volatile uint32_t tail; /* Next read index, written by consumer only */
+    volatile uint32_t dropped; /* Bytes rejected because buffer was full */
+} ring_buffer_t;
+
+/*******************************************************************************
+* Function Name: ring_buffer_init
+********************************************************************************
+* Summary:
+* Initializes the ring buffer over the given storage.
+*
+* Parameters:
+*  rb - ring buffer object
+*  storage - backing memory
+*  size - size of storage in bytes, must be a power of two
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+__STATIC_INLINE void ring_buffer_init(ring_buffer_t *rb, uint8_t *storage,
+                                      uint32_t size)
+{
+    CY_ASSERT((size != 0U) && ((size & (size - 1U)) == 0U));
+
+    rb->data = storage;
+    rb->mask = size - 1U;
+    rb->head = 0U;
+    rb->tail = 0U;
+    rb->dropped = 0U;
+}
+
+/*******************************************************************************
+* Function Name: ring_buffer_count
+********************************************************************************
+* Summary:
+* Returns the number of bytes currently stored.
+*
+* Parameters:
+*  rb - ring buffer object
+*
+* Return:
+*  uint32_t - number of bytes available to pop
+*
+*******************************************************************************/
+__STATIC_INLINE uint32_t ring_buffer_count(const ring_buffer_t *rb)
+{
+    return (rb->head - rb->tail);
+}
+
+/*******************************************************************************
+* Function Name: ring_buffer_is_empty
+********************************************************************************
+* Summary:
+* Checks whether the ring buffer holds no data.
+*
+* Parameters:
+*  rb - ring buffer object
+*
+* Return:
+*  bool - true if empty
+*
+*******************************************************************************/
+__STATIC_INLINE bool ring_buffer_is_empty(const ring_buffer_t *rb)
+{
+    return (rb->head == rb->tail);
+}
+
+/*******************************************************************************
+* Function Name: ring_buffer_push
+********************************************************************************
+* Summary:
+* Pushes one byte. Must only be called from the producer context. The byte is
+* stored before the head index is published so the consumer never sees stale
+* data.
+*
+* Parameters:
+*  rb - ring buffer object
+*  value - byte to store
+*
+* Return:
+*  bool - false if the buffer was full and the byte was dropped
+*
+*******************************************************************************/
+__STATIC_INLINE bool ring_buffer_push(ring_buffer_t *rb, uint8_t value)
+{
+    uint32_t head = rb->head;
+
+    if ((head - rb->tail) > rb->mask)
+    {
+        rb->dropped++;
+        return false;
+    }
+
+    rb->data[head & rb->mask] = value;
+    __DMB();
+    rb->head = head + 1U;
+
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: ring_buffer_pop
+********************************************************************************
+* Summary:
+* Pops one byte. Must only be called from the consumer context.
+*
+* Parameters:
+*  rb - ring buffer object
+*  value - location to store the byte
+*
+* Return:
+*  bool - false if the buffer was empty
+*
+*******************************************************************************/
+__STATIC_INLINE bool ring_buffer_pop(ring_buffer_t *rb, uint8_t *value)
+{
+    uint32_t tail = rb->tail;
+
+    if (tail == rb->head)
+    {
+        return false;
+    }
+
+    __DMB();
+    *value = rb->data[tail & rb->mask];
+    __DMB();
+    rb->tail = tail + 1U;
+
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: ring_buffer_space
+********************************************************************************
+* Summary:
+* Returns the number of bytes that can still be pushed.
+*
+* Parameters:
+*  rb - ring buffer object
+*
+* Return:
+*  uint32_t - free space in bytes
+*
+*******************************************************************************/
+__STATIC_INLINE uint32_t ring_buffer_space(const ring_buffer_t *rb)
+{
+    return ((rb->mask + 1U) - (rb->head - rb->tail));
+}
+
+/*******************************************************************************
+* Function Name: ring_buffer_write
+********************************************************************************
+* Summary:
+* Pushes a block of bytes. Must only be called from the producer context. The
+* block is stored completely or not at all.
+*
+* Parameters:
+*  rb - ring buffer object
+*  src - bytes to store
+*  length - number of bytes
+*
+* Return:
+*  bool - false if there was not enough space and nothing was stored
+*
+*******************************************************************************/
+__STATIC_INLINE bool ring_buffer_write(ring_buffer_t *rb, const uint8_t *src,
+                                       uint32_t length)
+{
+    uint32_t head = rb->head;
+    uint32_t i;
+
+    if (length > ring_buffer_space(rb))
+    {
+        rb->dropped += length;
+        return false;
+    }
+
+    for (i = 0U; i < length; i++)
+    {
+        rb->data[(head + i) & rb->mask] = src[i];
+    }
+    __DMB();
+    rb->head = head + length;
+
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: ring_buffer_peek_linear
+********************************************************************************
+* Summary:
+* Returns the longest run of stored bytes that is contiguous in memory, for
+* example to hand it to a DMA or an asynchronous transfer. The bytes stay in
+* the buffer until ring_buffer_consume() is called. Must only be called from
+* the consumer context.
+*
+* Parameters:
+*  rb - ring buffer object
+*  data - location to store the pointer to the first byte
+*
+* Return:
+*  uint32_t - number of contiguous bytes, 0 if empty
+*
+*******************************************************************************/
+__STATIC_INLINE uint32_t ring_buffer_peek_linear(const ring_buffer_t *rb,
+                                                 const uint8_t **data)
+{
+    uint32_t tail = rb->tail;
+    uint32_t count = rb->head - tail;
+    uint32_t to_end = (rb->mask + 1U) - (tail & rb->mask);
+
+    __DMB();
+    *data = &rb->data[tail & rb->mask];
+
+    return (count < to_end) ? count : to_end;
+}
+
+/*******************************************************************************
+* Function Name: ring_buffer_consume
+********************************************************************************
+* Summary:
+* Releases bytes returned by ring_buffer_peek_linear(). Must only be called
+* from the consumer context.
+*
+* Parameters:
+*  rb - ring buffer object
+*  length - number of bytes to release
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+__STATIC_INLINE void ring_buffer_consume(ring_buffer_t *rb, uint32_t length)
+{
+    CY_ASSERT(length <= ring_buffer_count(rb));
+
+    __DMB();
+    rb->tail += length;
+}
+
+#endif /* RING_BUFFER_H_ */
@@ -0,0 +1,226 @@
+/*******************************************************************************
+* File Name:   setpoint_ipc.c
+*
+* Description: Setpoint mailbox between the two cores. The sender copies a
+* setpoint into a mailbox in shared SRAM and passes its address through a
+* user IPC channel, whose lock stays acquired until the receiver has copied
+* the mailbox, so a setpoint is never overwritten while being read. The
+* receiver is the IPC notify interrupt of the CM4 and is the only staging
+* context of the update engine in this configuration.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include "cy_pdl.h"
+#include "app_config.h"
+#include "pwm_update.h"
+#include "setpoint_ipc.h"
+
+#if (SETPOINT_IPC_ENABLE)
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+static void setpoint_ipc_isr(void);
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+/* Mailbox of the sender, in the section shared by both cores */
+CY_SECTION_SHAREDMEM static setpoint_ipc_msg_t mailbox;
+
+static volatile uint32_t receive_count = 0U; /* Setpoints staged */
+static volatile uint32_t reject_count = 0U;  /* Setpoints out of range */
+
+/*******************************************************************************
+* Function Name: setpoint_ipc_send
+********************************************************************************
+* Summary:
+* Sends a setpoint to the CM4. Runs on the CM0+, which validates the setpoint
+* before. Does not wait: while the CM4 has not taken the previous setpoint
+* the channel stays locked and the call fails, so the caller can keep the
+* newest setpoint and send it on a later call.
+*
+* Parameters:
+*  setpoint - validated period and compare values
+*
+* Return:
+*  bool - true if the setpoint was sent, false if the channel is busy
+*
+*******************************************************************************/
+bool setpoint_ipc_send(const setpoint_ipc_msg_t *setpoint)
+{
+    IPC_STRUCT_Type *ipc = Cy_IPC_Drv_GetIpcBaseAddress(SETPOINT_IPC_CHANNEL);
+
+    if (Cy_IPC_Drv_IsLockAcquired(ipc))
+    {
+        return false;
+    }
+
+    mailbox = *setpoint;
+
+    /* Acquires the lock, passes the mailbox address and notifies the CM4 */
+    return (CY_IPC_DRV_SUCCESS ==
+            Cy_IPC_Drv_SendMsgPtr(ipc, (1UL << SETPOINT_IPC_INTR), &mailbox));
+}
+
+/*******************************************************************************
+* Function Name: setpoint_ipc_init
+********************************************************************************
+* Summary:
+* Enables the notify interrupt of the setpoint channel on the CM4. The update
+* engine must already be initialized.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void setpoint_ipc_init(void)
+{
+    IPC_INTR_STRUCT_Type *intr = Cy_IPC_Drv_GetIntrBaseAddr(SETPOINT_IPC_INTR);
+    const cy_stc_sysint_t ipc_irq_cfg =
+    {
+        .intrSrc = (IRQn_Type)(cpuss_interrupts_ipc_0_IRQn + SETPOINT_IPC_INTR),
+        .intrPriority = SETPOINT_IPC_IRQ_PRIORITY
+    };
+
+    Cy_IPC_Drv_ClearInterrupt(intr, CY_IPC_NO_NOTIFICATION,
+                              (1UL << SETPOINT_IPC_CHANNEL));
+    Cy_IPC_Drv_SetInterruptMask(intr, CY_IPC_NO_NOTIFICATION,
+                                (1UL << SETPOINT_IPC_CHANNEL));
+
+    if (CY_SYSINT_SUCCESS != Cy_SysInt_Init(&ipc_irq_cfg, setpoint_ipc_isr))
+    {
+        CY_ASSERT(0);
+    }
+    NVIC_ClearPendingIRQ(ipc_irq_cfg.intrSrc);
+    NVIC_EnableIRQ(ipc_irq_cfg.intrSrc);
+}
+
+/*******************************************************************************
+* Function Name: setpoint_ipc_get_count
+********************************************************************************
+* Summary:
+* Returns the number of setpoints received and staged.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  uint32_t - setpoint count
+*
+*******************************************************************************/
+uint32_t setpoint_ipc_get_count(void)
+{
+    return receive_count;
+}
+
+/*******************************************************************************
+* Function Name: setpoint_ipc_get_rejected
+********************************************************************************
+* Summary:
+* Returns the number of received setpoints that were out of range and not
+* staged. The sender validates the setpoints, so this should stay 0.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  uint32_t - rejected setpoint count
+*
+*******************************************************************************/
+uint32_t setpoint_ipc_get_rejected(void)
+{
+    return reject_count;
+}
+
+/*******************************************************************************
+* Function Name: setpoint_ipc_isr
+********************************************************************************
+* Summary:
+* IPC notify interrupt handler of the CM4. Copies the mailbox, releases the
+* channel for the next setpoint and stages the setpoint to the update engine.
+* A setpoint out of range is dropped, as a wrong period or compare value
+* from the other core must never reach the counter.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void setpoint_ipc_isr(void)
+{
+    IPC_INTR_STRUCT_Type *intr = Cy_IPC_Drv_GetIntrBaseAddr(SETPOINT_IPC_INTR);
+    IPC_STRUCT_Type *ipc = Cy_IPC_Drv_GetIpcBaseAddress(SETPOINT_IPC_CHANNEL);
+    uint32_t masked = Cy_IPC_Drv_GetInterruptStatusMasked(intr);
+    setpoint_ipc_msg_t setpoint;
+    void *message;
+
+    if (0U == (Cy_IPC_Drv_ExtractAcquireMask(masked) &
+               (1UL << SETPOINT_IPC_CHANNEL)))
+    {
+        return;
+    }
+    Cy_IPC_Drv_ClearInterrupt(intr, CY_IPC_NO_NOTIFICATION,
+                              (1UL << SETPOINT_IPC_CHANNEL));
+
+    if (CY_IPC_DRV_SUCCESS != Cy_IPC_Drv_ReadMsgPtr(ipc, &message))
+    {
+        return;
+    }
+    setpoint = *(const setpoint_ipc_msg_t *)message;
+    (void)Cy_IPC_Drv_LockRelease(ipc, CY_IPC_NO_NOTIFICATION);
+
+    if ((setpoint.period < PWM_UPDATE_PERIOD_MIN) ||
+        (setpoint.period > PWM_UPDATE_PERIOD_MAX) ||
+        (setpoint.compare0 > setpoint.period) ||
+        (setpoint.compare1 > setpoint.period))
+    {
+        reject_count++;
+        return;
+    }
+
+    pwm_update_stage_period(setpoint.period, setpoint.compare0,
+                            setpoint.compare1);
+    receive_count++;
+}
+
+#endif /* SETPOINT_IPC_ENABLE */
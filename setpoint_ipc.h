@@ -0,0 +1,75 @@
+/*******************************************************************************
+* File Name:   setpoint_ipc.h
+*
+* Description: Setpoint mailbox between the two cores for the split-core
+* configuration. The CM0+ owns the UART command path and sends validated
+* period and CC0/CC1 setpoints; the CM4 receives them in an IPC interrupt and
+* stages them to the update engine, so serial I/O never runs on the core of
+* the terminal count ISR.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef SETPOINT_IPC_H_
+#define SETPOINT_IPC_H_
+
+#include "cy_pdl.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define SETPOINT_IPC_IRQ_PRIORITY (2) /* Below the commit ISR */
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+/* Setpoint passed from the CM0+ to the CM4 */
+typedef struct
+{
+    uint32_t period;   /* Period in counter ticks */
+    uint32_t compare0; /* CC0 value, at most period */
+    uint32_t compare1; /* CC1 value, at most period */
+} setpoint_ipc_msg_t;
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+bool setpoint_ipc_send(const setpoint_ipc_msg_t *setpoint);
+void setpoint_ipc_init(void);
+uint32_t setpoint_ipc_get_count(void);
+uint32_t setpoint_ipc_get_rejected(void);
+
+#endif /* SETPOINT_IPC_H_ */
@@ -0,0 +1,247 @@
+/*******************************************************************************
+* File Name:   telemetry.c
+*
+* Description: Periodic binary telemetry of the applied waveform. The ISR
+* side only counts periods and copies three values once per decimation
+* interval; the frame is built and queued in the main loop.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include "cy_pdl.h"
+#include "pwm_port.h"
+#include "app_config.h"
+#include "app_log.h"
+#include "cmd_protocol.h"
+#include "latency_trace.h"
+#include "pwm_update.h"
+#include "telemetry.h"
+
+#if (TELEMETRY_ENABLE)
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+typedef struct
+{
+    uint32_t period;   /* Last committed period */
+    uint32_t compare0; /* Last committed CC0 value */
+    uint32_t compare1; /* Last committed CC1 value */
+} telemetry_sample_t;
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+static uint32_t telemetry_put16(uint8_t *buffer, uint32_t value);
+static uint32_t telemetry_put32(uint8_t *buffer, uint32_t value);
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+static volatile uint32_t decimation = TELEMETRY_DECIMATION; /* 0 for off */
+static uint32_t elapsed = 0U; /* Periods since the last sample, ISR only */
+
+/* The sample is written by the ISR while sample_ready is false and read by
+ * the main loop while it is true. A barrier orders the sample accesses
+ * before each change of the flag. */
+static telemetry_sample_t sample;
+static volatile bool sample_ready = false;
+static volatile uint32_t overrun_count = 0U; /* Samples not sent in time */
+
+/*******************************************************************************
+* Function Name: telemetry_set_decimation
+********************************************************************************
+* Summary:
+* Sets the number of PWM periods per telemetry frame. The rate must leave
+* room for the frames on the UART: a frame of TELEMETRY_PAYLOAD_SIZE +
+* CMD_PROTOCOL_FRAME_OVERHEAD bytes takes about 3 ms at 115200 baud.
+*
+* Parameters:
+*  periods - PWM periods per frame, 0 to stop the telemetry
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void telemetry_set_decimation(uint32_t periods)
+{
+    decimation = periods;
+}
+
+/*******************************************************************************
+* Function Name: telemetry_tick
+********************************************************************************
+* Summary:
+* Counts one PWM period and samples the applied values once per decimation
+* interval. Called from the terminal count ISR. If the main loop has not sent
+* the previous sample yet, the new one is dropped and counted.
+*
+* Parameters:
+*  period - last committed period
+*  compare0 - last committed CC0 value
+*  compare1 - last committed CC1 value
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+PWM_RAMFUNC_BEGIN
+void telemetry_tick(uint32_t period, uint32_t compare0, uint32_t compare1)
+{
+    uint32_t periods = decimation;
+
+    if ((0U == periods) || (++elapsed < periods))
+    {
+        return;
+    }
+    elapsed = 0U;
+
+    if (sample_ready)
+    {
+        overrun_count++;
+        return;
+    }
+
+    sample.period = period;
+    sample.compare0 = compare0;
+    sample.compare1 = compare1;
+    __DMB();
+    sample_ready = true;
+}
+PWM_RAMFUNC_END
+
+/*******************************************************************************
+* Function Name: telemetry_poll
+********************************************************************************
+* Summary:
+* Sends a pending sample as a telemetry frame (opcode 0x10 with the response
+* flag). Besides the applied values, the frame carries the commit, missed
+* swap and telemetry overrun counts and, with LATENCY_TRACE_ENABLE, the
+* sample count, minimum and maximum of the command-to-swap latency in CPU
+* cycles. Called from the main loop.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void telemetry_poll(void)
+{
+    uint8_t payload[TELEMETRY_PAYLOAD_SIZE];
+    uint8_t frame[TELEMETRY_PAYLOAD_SIZE + CMD_PROTOCOL_FRAME_OVERHEAD];
+    uint32_t length = 0U;
+    uint32_t frame_length;
+#if (LATENCY_TRACE_ENABLE)
+    latency_stats_t stats;
+#endif
+
+    if (!sample_ready)
+    {
+        return;
+    }
+
+    length += telemetry_put16(&payload[length], sample.period);
+    length += telemetry_put16(&payload[length], sample.compare0);
+    length += telemetry_put16(&payload[length], sample.compare1);
+    __DMB();
+    sample_ready = false;
+
+    length += telemetry_put32(&payload[length], pwm_update_get_commit_count());
+    length += telemetry_put32(&payload[length], pwm_update_get_missed_count());
+    length += telemetry_put32(&payload[length], overrun_count);
+#if (LATENCY_TRACE_ENABLE)
+    latency_trace_get_stats(LATENCY_STAGE_SWAP_TRIGGER, &stats);
+    length += telemetry_put32(&payload[length], stats.count);
+    length += telemetry_put32(&payload[length], stats.min);
+    length += telemetry_put32(&payload[length], stats.max);
+#else
+    length += telemetry_put32(&payload[length], 0U);
+    length += telemetry_put32(&payload[length], 0U);
+    length += telemetry_put32(&payload[length], 0U);
+#endif
+
+    frame_length = cmd_protocol_build_frame(CMD_PROTOCOL_OP_TELEMETRY, payload,
+                                            length, frame);
+    app_log_write((const char *)frame, frame_length);
+}
+
+/*******************************************************************************
+* Function Name: telemetry_put16
+********************************************************************************
+* Summary:
+* Stores a 16-bit field little endian.
+*
+* Parameters:
+*  buffer - destination
+*  value - field value
+*
+* Return:
+*  uint32_t - number of bytes stored
+*
+*******************************************************************************/
+static uint32_t telemetry_put16(uint8_t *buffer, uint32_t value)
+{
+    buffer[0] = (uint8_t)(value & 0xFFU);
+    buffer[1] = (uint8_t)((value >> 8U) & 0xFFU);
+
+    return 2U;
+}
+
+/*******************************************************************************
+* Function Name: telemetry_put32
+********************************************************************************
+* Summary:
+* Stores a 32-bit field little endian.
+*
+* Parameters:
+*  buffer - destination
+*  value - field value
+*
+* Return:
+*  uint32_t - number of bytes stored
+*
+*******************************************************************************/
+static uint32_t telemetry_put32(uint8_t *buffer, uint32_t value)
+{
+    (void)telemetry_put16(&buffer[0], value & 0xFFFFU);
+    (void)telemetry_put16(&buffer[2], value >> 16U);
+
+    return 4U;
+}
+
+#endif /* TELEMETRY_ENABLE */
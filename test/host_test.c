@@ -0,0 +1,727 @@
+/*******************************************************************************
+* File Name:   host_test.c
+*
+* Description: Host test of the waveform kernels. Builds pwm_keys.h,
+* pwm_math.h, pwm_ramp.h, pwm_sequence.h, pwm_svpwm.c and cmd_protocol.c
+* for a desktop compiler through the PWM_PORT_HOST shim of pwm_port.h and
+* checks the key handling, the slew, the ramp and sequencer steps of the
+* terminal count ISR and the space-vector duty cycles, fuzzes the frame
+* parser and reports the throughput of the kernels. Run
+* test/run_host_test.sh; the program prints every failed check and exits
+* with a nonzero status on failure.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "pwm_port.h"
+#include "pwm_math.h"
+#include "pwm_keys.h"
+#include "pwm_ramp.h"
+#include "pwm_sequence.h"
+#include "pwm_svpwm.h"
+#include "cmd_protocol.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define TEST_PERIOD             (2000)
+#define TEST_STEP               (100)
+#define TEST_SVPWM_TOLERANCE    (2)  /* Largest duty error in Q15 LSB */
+#define TEST_SVPWM_ANGLES       (360)
+#define TEST_FUZZ_BYTES         (1000000U) /* Random bytes into the parser */
+#define TEST_FUZZ_ITEMS         (200000U)  /* Keys and frames, mixed */
+#define TEST_THROUGHPUT_COUNT   (10000000U)
+#define TEST_SEQUENCE_HOLD      (-1)
+#define TEST_SEQUENCE_END       (-2)
+
+#define TEST_CHECK(condition) \
+    test_check((condition), #condition, __FILE__, __LINE__)
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+static unsigned int test_count = 0U;
+static unsigned int test_failures = 0U;
+static uint32_t test_random_state = 0x2545F491U;
+static volatile uint32_t test_sink; /* Keeps the timed results alive */
+
+/*******************************************************************************
+* Function Name: test_check
+********************************************************************************
+* Summary:
+* Counts a check and prints it if it failed.
+*
+* Parameters:
+*  passed - result of the check
+*  text - source text of the check
+*  file - source file
+*  line - source line
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void test_check(bool passed, const char *text, const char *file,
+                       int line)
+{
+    test_count++;
+    if (!passed)
+    {
+        test_failures++;
+        printf("%s:%d: check failed: %s\n", file, line, text);
+    }
+}
+
+/*******************************************************************************
+* Function Name: test_random
+********************************************************************************
+* Summary:
+* Returns the next value of a xorshift generator, so every run feeds the
+* same bytes.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  uint32_t - pseudo-random value
+*
+*******************************************************************************/
+static uint32_t test_random(void)
+{
+    test_random_state ^= test_random_state << 13U;
+    test_random_state ^= test_random_state >> 17U;
+    test_random_state ^= test_random_state << 5U;
+
+    return test_random_state;
+}
+
+/*******************************************************************************
+* Function Name: test_frame
+********************************************************************************
+* Summary:
+* Builds a frame as sent by a host, with its CRC.
+*
+* Parameters:
+*  opcode - opcode of the frame
+*  payload - payload bytes
+*  length - payload length
+*  frame - output buffer of at least length + CMD_PROTOCOL_FRAME_OVERHEAD
+*          bytes
+*
+* Return:
+*  uint32_t - frame length in bytes
+*
+*******************************************************************************/
+static uint32_t test_frame(uint8_t opcode, const uint8_t *payload,
+                           uint32_t length, uint8_t *frame)
+{
+    uint16_t crc = 0xFFFFU;
+    uint32_t i;
+
+    frame[0] = CMD_PROTOCOL_SYNC;
+    frame[1] = opcode;
+    frame[2] = (uint8_t)length;
+    for (i = 0U; i < length; i++)
+    {
+        frame[3U + i] = payload[i];
+    }
+    for (i = 1U; i < (3U + length); i++)
+    {
+        crc = cmd_protocol_crc16(crc, frame[i]);
+    }
+    frame[3U + length] = (uint8_t)(crc & 0xFFU);
+    frame[4U + length] = (uint8_t)(crc >> 8U);
+
+    return length + CMD_PROTOCOL_FRAME_OVERHEAD;
+}
+
+/*******************************************************************************
+* Function Name: test_keys
+********************************************************************************
+* Summary:
+* Checks the compare changes of the waveform keys and their limits.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void test_keys(void)
+{
+    int32_t compare0 = 1000;
+    int32_t compare1 = 1000;
+
+    TEST_CHECK(pwm_keys_apply('s', TEST_STEP, TEST_PERIOD, &compare0,
+                              &compare1));
+    TEST_CHECK((1100 == compare0) && (1100 == compare1));
+
+    TEST_CHECK(pwm_keys_apply('w', TEST_STEP, TEST_PERIOD, &compare0,
+                              &compare1));
+    TEST_CHECK((1000 == compare0) && (1000 == compare1));
+
+    TEST_CHECK(pwm_keys_apply('a', TEST_STEP, TEST_PERIOD, &compare0,
+                              &compare1));
+    TEST_CHECK((900 == compare0) && (1100 == compare1));
+
+    TEST_CHECK(pwm_keys_apply('d', TEST_STEP, TEST_PERIOD, &compare0,
+                              &compare1));
+    TEST_CHECK((1000 == compare0) && (1000 == compare1));
+
+    /* Other keys leave the compare values alone */
+    TEST_CHECK(!pwm_keys_apply('u', TEST_STEP, TEST_PERIOD, &compare0,
+                               &compare1));
+    TEST_CHECK((1000 == compare0) && (1000 == compare1));
+
+    /* Both compare values stop at the period and at 0 */
+    compare0 = TEST_PERIOD - 50;
+    compare1 = TEST_PERIOD - 50;
+    (void)pwm_keys_apply('s', TEST_STEP, TEST_PERIOD, &compare0, &compare1);
+    TEST_CHECK((TEST_PERIOD == compare0) && (TEST_PERIOD == compare1));
+
+    compare0 = 50;
+    compare1 = 50;
+    (void)pwm_keys_apply('w', TEST_STEP, TEST_PERIOD, &compare0, &compare1);
+    TEST_CHECK((0 == compare0) && (0 == compare1));
+
+    compare0 = 50;
+    compare1 = TEST_PERIOD - 50;
+    (void)pwm_keys_apply('a', TEST_STEP, TEST_PERIOD, &compare0, &compare1);
+    TEST_CHECK((0 == compare0) && (TEST_PERIOD == compare1));
+}
+
+/*******************************************************************************
+* Function Name: test_math
+********************************************************************************
+* Summary:
+* Checks the clamp, the slew step of the ramp, and the conversion between
+* duty cycle and phase and the compare pair.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void test_math(void)
+{
+    pwm_math_t math;
+    uint32_t position;
+    uint32_t compare0;
+    uint32_t compare1;
+    uint32_t steps;
+
+    TEST_CHECK(0 == pwm_math_clamp(-5, TEST_PERIOD));
+    TEST_CHECK(700 == pwm_math_clamp(700, TEST_PERIOD));
+    TEST_CHECK(TEST_PERIOD == pwm_math_clamp(TEST_PERIOD + 1, TEST_PERIOD));
+
+    /* Ramp up in steps of 2.5 ticks: 40 full steps to reach 100 ticks */
+    position = 0U;
+    for (steps = 0U; (position != (100U << 16U)) && (steps < 1000U); steps++)
+    {
+        uint32_t next = pwm_math_slew(position, 100U << 16U, 0x28000U);
+
+        TEST_CHECK((next - position) <= 0x28000U);
+        position = next;
+    }
+    TEST_CHECK(40U == steps);
+
+    /* Down, the last step ends exactly on the target */
+    position = pwm_math_slew(10U << 16U, 9U << 16U, 0x28000U);
+    TEST_CHECK((9U << 16U) == position);
+    position = pwm_math_slew(100U << 16U, 0U, 0x28000U);
+    TEST_CHECK(((100U << 16U) - 0x28000U) == position);
+
+    /* 25 % duty cycle, centered and shifted by 10 % of the period */
+    pwm_math_init(&math, TEST_PERIOD);
+    pwm_math_to_compare(&math, PWM_MATH_Q15_ONE / 4, 0, &compare0, &compare1);
+    TEST_CHECK((1500U == compare0) && (1500U == compare1));
+    pwm_math_to_compare(&math, PWM_MATH_Q15_ONE / 4, 3277, &compare0,
+                        &compare1);
+    TEST_CHECK((1700U == compare0) && (1300U == compare1));
+    TEST_CHECK(labs(pwm_math_duty(&math, compare0, compare1) -
+                    (PWM_MATH_Q15_ONE / 4)) <= 1L);
+    TEST_CHECK(labs(pwm_math_phase(&math, compare0, compare1) - 3277L) <= 2L);
+    TEST_CHECK(850U == pwm_math_rescale(1700U, TEST_PERIOD, TEST_PERIOD / 2));
+}
+
+/*******************************************************************************
+* Function Name: test_svpwm
+********************************************************************************
+* Summary:
+* Compares the space-vector duty cycles with a floating-point reference of
+* min-max zero sequence injection, around the circle and for several
+* amplitudes of the linear range.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void test_svpwm(void)
+{
+    static const double amplitudes[] = { 0.0, 0.25, 0.5, 0.75, 0.99 };
+    const double pi = 3.14159265358979323846;
+    int32_t duty[PWM_SVPWM_PHASES];
+    double voltage[PWM_SVPWM_PHASES];
+    double highest;
+    double lowest;
+    int32_t expected;
+    int32_t worst = 0;
+    unsigned int amplitude;
+    unsigned int angle;
+    unsigned int phase;
+
+    for (amplitude = 0U;
+         amplitude < (sizeof(amplitudes) / sizeof(amplitudes[0]));
+         amplitude++)
+    {
+        for (angle = 0U; angle < TEST_SVPWM_ANGLES; angle++)
+        {
+            double theta = (2.0 * pi * angle) / TEST_SVPWM_ANGLES;
+            double alpha = amplitudes[amplitude] * cos(theta);
+            double beta = amplitudes[amplitude] * sin(theta);
+
+            pwm_svpwm_duty((int32_t)lround(alpha * PWM_MATH_Q15_ONE),
+                           (int32_t)lround(beta * PWM_MATH_Q15_ONE), duty);
+
+            /* Phase voltages in Vdc/sqrt(3), centered between the
+             * highest and the lowest phase */
+            voltage[0] = alpha;
+            voltage[1] = (-alpha / 2.0) + ((sqrt(3.0) / 2.0) * beta);
+            voltage[2] = (-alpha / 2.0) - ((sqrt(3.0) / 2.0) * beta);
+            highest = fmax(voltage[0], fmax(voltage[1], voltage[2]));
+            lowest = fmin(voltage[0], fmin(voltage[1], voltage[2]));
+
+            for (phase = 0U; phase < PWM_SVPWM_PHASES; phase++)
+            {
+                expected = (int32_t)lround(
+                    (0.5 + ((voltage[phase] - ((highest + lowest) / 2.0)) /
+                            sqrt(3.0))) * PWM_MATH_Q15_ONE);
+                if (abs(duty[phase] - expected) > worst)
+                {
+                    worst = abs(duty[phase] - expected);
+                }
+                TEST_CHECK((duty[phase] >= 0) &&
+                           (duty[phase] <= PWM_MATH_Q15_ONE));
+            }
+        }
+    }
+
+    printf("svpwm: largest duty error %ld LSB\n", (long)worst);
+    TEST_CHECK(worst <= TEST_SVPWM_TOLERANCE);
+}
+
+/*******************************************************************************
+* Function Name: test_ramp
+********************************************************************************
+* Summary:
+* Checks the ramp step of the terminal count ISR: the number of periods to
+* reach a target, the size of each step, a target changed during a ramp,
+* slew rates below one tick per period, and the jump for a slew rate of 0
+* or a new period.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void test_ramp(void)
+{
+    pwm_ramp_t ramp;
+    uint32_t compare0 = 1000U;
+    uint32_t compare1 = 1000U;
+    uint32_t last0;
+    uint32_t last1;
+    uint32_t periods = 0U;
+    bool active = true;
+
+    /* 100 ticks apart at 2.5 ticks per period: 40 periods */
+    pwm_ramp_init(&ramp, compare0, compare1);
+    while (active && (periods < 1000U))
+    {
+        last0 = compare0;
+        last1 = compare1;
+        active = pwm_ramp_step(&ramp, 1100U, 900U, 0x28000U, false,
+                               &compare0, &compare1);
+        TEST_CHECK((compare0 >= last0) && ((compare0 - last0) <= 3U));
+        TEST_CHECK((compare1 <= last1) && ((last1 - compare1) <= 3U));
+        periods++;
+    }
+    TEST_CHECK(40U == periods);
+    TEST_CHECK((1100U == compare0) && (900U == compare1));
+
+    /* A new target during the ramp is approached from where the ramp is */
+    pwm_ramp_init(&ramp, 1000U, 1000U);
+    for (periods = 0U; periods < 10U; periods++)
+    {
+        (void)pwm_ramp_step(&ramp, 1100U, 1100U, 0x10000U, false, &compare0,
+                            &compare1);
+    }
+    TEST_CHECK((1010U == compare0) && (1010U == compare1));
+    TEST_CHECK(pwm_ramp_step(&ramp, 1000U, 1000U, 0x10000U, false,
+                             &compare0, &compare1));
+    TEST_CHECK((1009U == compare0) && (1009U == compare1));
+
+    /* A quarter tick per period: one tick takes four periods */
+    pwm_ramp_init(&ramp, 500U, 500U);
+    for (periods = 0U; periods < 3U; periods++)
+    {
+        TEST_CHECK(pwm_ramp_step(&ramp, 501U, 501U, 0x4000U, false,
+                                 &compare0, &compare1));
+        TEST_CHECK((500U == compare0) && (500U == compare1));
+    }
+    TEST_CHECK(!pwm_ramp_step(&ramp, 501U, 501U, 0x4000U, false, &compare0,
+                              &compare1));
+    TEST_CHECK((501U == compare0) && (501U == compare1));
+
+    /* No slew rate, or a new period: straight to the target */
+    pwm_ramp_init(&ramp, 0U, 2000U);
+    TEST_CHECK(!pwm_ramp_step(&ramp, 2000U, 0U, 0U, false, &compare0,
+                              &compare1));
+    TEST_CHECK((2000U == compare0) && (0U == compare1));
+    TEST_CHECK(!pwm_ramp_step(&ramp, 250U, 750U, 0x100U, true, &compare0,
+                              &compare1));
+    TEST_CHECK((250U == compare0) && (750U == compare1));
+}
+
+/*******************************************************************************
+* Function Name: test_sequence
+********************************************************************************
+* Summary:
+* Checks the sequencer step of the terminal count ISR through two passes of
+* a table, period by period, and the stop of an endless sequence.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void test_sequence(void)
+{
+    static const pwm_sequence_step_t steps[] =
+    {
+        { 100U, 200U, 0U, 2U },
+        { 300U, 400U, 2500U, 1U },
+        { 500U, 600U, 0U, 3U }
+    };
+    /* Event of each period: step index, hold or end */
+    static const int expected[] =
+    {
+        0, TEST_SEQUENCE_HOLD, 1, 2, TEST_SEQUENCE_HOLD, TEST_SEQUENCE_HOLD,
+        0, TEST_SEQUENCE_HOLD, 1, 2, TEST_SEQUENCE_HOLD, TEST_SEQUENCE_HOLD,
+        TEST_SEQUENCE_END
+    };
+    pwm_sequence_t sequence;
+    const pwm_sequence_step_t *step = NULL;
+    pwm_sequence_event_t event;
+    unsigned int period;
+    int actual;
+
+    pwm_sequence_start(&sequence, steps, 3U, 2U);
+    for (period = 0U; period < (sizeof(expected) / sizeof(expected[0]));
+         period++)
+    {
+        event = pwm_sequence_advance(&sequence, false, &step);
+        actual = (PWM_SEQUENCE_END == event) ? TEST_SEQUENCE_END :
+                 (PWM_SEQUENCE_HOLD == event) ? TEST_SEQUENCE_HOLD :
+                 (int)(step - steps);
+        TEST_CHECK(expected[period] == actual);
+    }
+
+    /* Endless until stopped, also in the middle of a step */
+    pwm_sequence_start(&sequence, steps, 3U, 0U);
+    for (period = 0U; period < 1000U; period++)
+    {
+        TEST_CHECK(PWM_SEQUENCE_END !=
+                   pwm_sequence_advance(&sequence, false, &step));
+    }
+    TEST_CHECK(PWM_SEQUENCE_END == pwm_sequence_advance(&sequence, true,
+                                                        &step));
+}
+
+/*******************************************************************************
+* Function Name: test_protocol_fuzz
+********************************************************************************
+* Summary:
+* Feeds the frame parser random bytes, then a random mix of single keys,
+* valid frames, frames with a bad CRC and frames with a length beyond the
+* largest payload. Every key must be reported as a key and nothing else, and
+* every frame must end in the expected result on its last byte, or on its
+* length byte for an oversized frame.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void test_protocol_fuzz(void)
+{
+    uint8_t frame[255U + CMD_PROTOCOL_FRAME_OVERHEAD];
+    uint8_t payload[255];
+    cmd_protocol_command_t command;
+    cmd_protocol_result_t result;
+    cmd_protocol_result_t final;
+    uint32_t final_index;
+    uint32_t length;
+    uint32_t frame_length;
+    uint32_t item;
+    uint32_t i;
+    bool passed;
+
+    /* Random bytes: the parser must stay within its buffer and only
+     * report known results */
+    for (i = 0U; i < TEST_FUZZ_BYTES; i++)
+    {
+        result = cmd_protocol_feed((uint8_t)test_random(), &command);
+        if (result > CMD_PROTOCOL_ERROR)
+        {
+            TEST_CHECK(result <= CMD_PROTOCOL_ERROR);
+        }
+    }
+
+    /* A valid frame is decoded right after a reset */
+    cmd_protocol_reset();
+    payload[0] = 0x34U;
+    payload[1] = 0x12U;
+    payload[2] = 0x78U;
+    payload[3] = 0x06U;
+    payload[4] = 0xD0U;
+    payload[5] = 0x07U;
+    frame_length = test_frame(CMD_PROTOCOL_OP_SET_ABSOLUTE, payload, 6U, frame);
+    for (i = 0U; i < frame_length; i++)
+    {
+        result = cmd_protocol_feed(frame[i], &command);
+    }
+    TEST_CHECK(CMD_PROTOCOL_FRAME == result);
+    TEST_CHECK((0x1234 == command.value0) && (0x0678 == command.value1) &&
+               (2000 == command.value2));
+
+    for (item = 0U; item < TEST_FUZZ_ITEMS; item++)
+    {
+        switch (test_random() % 4U)
+        {
+            case 0U:
+                /* Single key, any byte but the sync byte */
+                do
+                {
+                    frame[0] = (uint8_t)test_random();
+                } while (CMD_PROTOCOL_SYNC == frame[0]);
+                frame_length = 1U;
+                final = CMD_PROTOCOL_KEY;
+                final_index = 0U;
+                break;
+            case 1U:
+                /* Valid absolute setpoint */
+                for (i = 0U; i < 4U; i++)
+                {
+                    payload[i] = (uint8_t)test_random();
+                }
+                frame_length = test_frame(CMD_PROTOCOL_OP_SET_ABSOLUTE,
+                                          payload, 4U, frame);
+                final = CMD_PROTOCOL_FRAME;
+                final_index = frame_length - 1U;
+                break;
+            case 2U:
+                /* Any opcode and payload, corrupted CRC */
+                length = test_random() % (CMD_PROTOCOL_MAX_PAYLOAD + 1U);
+                for (i = 0U; i < length; i++)
+                {
+                    payload[i] = (uint8_t)test_random();
+                }
+                frame_length = test_frame((uint8_t)test_random(), payload,
+                                          length, frame);
+                frame[frame_length - 1U] ^= (uint8_t)(1U + (test_random() %
+                                                            255U));
+                final = CMD_PROTOCOL_ERROR;
+                final_index = frame_length - 1U;
+                break;
+            default:
+                /* Oversized, with key and sync bytes in the payload */
+                length = CMD_PROTOCOL_MAX_PAYLOAD + 1U +
+                         (test_random() % (255U - CMD_PROTOCOL_MAX_PAYLOAD));
+                for (i = 0U; i < length; i++)
+                {
+                    payload[i] = (uint8_t)"wsad\xA5"[test_random() % 5U];
+                }
+                frame_length = test_frame((uint8_t)test_random(), payload,
+                                          length, frame);
+                final = CMD_PROTOCOL_ERROR;
+                final_index = 2U;
+                break;
+        }
+
+        passed = true;
+        for (i = 0U; i < frame_length; i++)
+        {
+            result = cmd_protocol_feed(frame[i], &command);
+            if (result != ((i == final_index) ? final : CMD_PROTOCOL_PENDING))
+            {
+                passed = false;
+            }
+        }
+        if ((CMD_PROTOCOL_FRAME == final) && passed)
+        {
+            passed = ((int32_t)(payload[0] | (payload[1] << 8U)) ==
+                      command.value0) &&
+                     ((int32_t)(payload[2] | (payload[3] << 8U)) ==
+                      command.value1) &&
+                     (0 == command.value2);
+        }
+        TEST_CHECK(passed);
+        if (!passed)
+        {
+            break;
+        }
+    }
+}
+
+/*******************************************************************************
+* Function Name: test_throughput
+********************************************************************************
+* Summary:
+* Times the kernels of the update path on the host and prints the rates.
+* The numbers compare host builds and revisions with each other, they say
+* nothing about the cycle cost on the device (see bench.c).
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void test_throughput(void)
+{
+    int32_t duty[PWM_SVPWM_PHASES];
+    uint8_t frame[4U + CMD_PROTOCOL_FRAME_OVERHEAD];
+    uint8_t payload[4] = { 0xE8U, 0x03U, 0xD0U, 0x07U };
+    cmd_protocol_command_t command;
+    pwm_ramp_t ramp;
+    uint32_t compare0 = 0U;
+    uint32_t compare1 = 0U;
+    uint32_t frame_length;
+    uint32_t frames = 0U;
+    uint32_t sum = 0U;
+    uint32_t i;
+    clock_t start;
+    double seconds;
+
+    pwm_ramp_init(&ramp, 0U, 0U);
+    start = clock();
+    for (i = 0U; i < TEST_THROUGHPUT_COUNT; i++)
+    {
+        /* A new target every 256 periods, 1.5 ticks per period */
+        (void)pwm_ramp_step(&ramp, (i >> 8U) & 0x7FFU, 2000U - ((i >> 8U) &
+                            0x7FFU), 0x18000U, false, &compare0, &compare1);
+        sum += compare0 ^ compare1;
+    }
+    seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+    printf("throughput: ramp %.1f M steps/s\n",
+           (TEST_THROUGHPUT_COUNT / 1e6) / ((seconds > 0.0) ? seconds : 1e-9));
+
+    start = clock();
+    for (i = 0U; i < TEST_THROUGHPUT_COUNT; i++)
+    {
+        pwm_svpwm_duty((int32_t)(i & 0x3FFFU) - 8192,
+                       8192 - (int32_t)((i >> 2U) & 0x3FFFU), duty);
+        sum += (uint32_t)duty[0];
+    }
+    seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+    printf("throughput: svpwm %.1f M updates/s\n",
+           (TEST_THROUGHPUT_COUNT / 1e6) / ((seconds > 0.0) ? seconds : 1e-9));
+
+    cmd_protocol_reset();
+    frame_length = test_frame(CMD_PROTOCOL_OP_SET_ABSOLUTE, payload, 4U,
+                              frame);
+    start = clock();
+    for (i = 0U; i < TEST_THROUGHPUT_COUNT; i++)
+    {
+        if (CMD_PROTOCOL_FRAME == cmd_protocol_feed(frame[i % frame_length],
+                                                    &command))
+        {
+            frames++;
+        }
+    }
+    seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+    printf("throughput: parser %.1f M frames/s\n",
+           (frames / 1e6) / ((seconds > 0.0) ? seconds : 1e-9));
+
+    TEST_CHECK((TEST_THROUGHPUT_COUNT / frame_length) == frames);
+    test_sink = sum;
+}
+
+/*******************************************************************************
+* Function Name: main
+********************************************************************************
+* Summary:
+* Runs all checks and reports the result.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  int - 0 if all checks passed
+*
+*******************************************************************************/
+int main(void)
+{
+    test_keys();
+    test_math();
+    test_ramp();
+    test_sequence();
+    test_svpwm();
+    test_protocol_fuzz();
+    test_throughput();
+
+    printf("%u checks, %u failed\n", test_count, test_failures);
+
+    return (0U == test_failures) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
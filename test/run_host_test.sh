@@ -0,0 +1,19 @@
+#!/bin/sh
+################################################################################
+# \file run_host_test.sh
+#
+# \brief
+# Builds the waveform kernels and the frame parser with the host compiler
+# (PWM_PORT_HOST) and runs the checks, the fuzz run and the throughput run of
+# host_test.c. Set CC to select the compiler.
+#
+################################################################################
+set -e
+
+cd "$(dirname "$0")/.."
+CC="${CC:-cc}"
+OUT="${TMPDIR:-/tmp}/pwm_host_test"
+
+"$CC" -std=c99 -O2 -Wall -Wextra -Werror -DPWM_PORT_HOST -I. \
+    test/host_test.c pwm_svpwm.c cmd_protocol.c -lm -o "$OUT"
+"$OUT"